@@ -105,7 +105,10 @@ int32 URetargetAPairCommandlet::Main(const FString& Params)
 
     auto retargeter = FRetargeterModule::Get();
     retargeter.SetPersistAssets(bPersist);
-    retargeter.RetargetAPair(InputFbx, TargetFbx, OutputPath);
+    if (!retargeter.RetargetAPair(InputFbx, TargetFbx, OutputPath)) {
+        UE_LOG(RetargeterCommandlet, Error, TEXT("Retargeting failed, no output written to %s"), *OutputPath);
+        return 1;
+    }
 
     return 0;
 }
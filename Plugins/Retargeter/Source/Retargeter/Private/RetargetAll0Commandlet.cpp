@@ -18,6 +18,12 @@
 #include "Misc/CoreMisc.h"
 
 #include "HAL/PlatformProcess.h"
+#include "RetargetSocket.h"
+#include "RetargetManifest.h"
+#include "RetargetMetrics.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 
 URetargetAll0Commandlet::URetargetAll0Commandlet() { LogToConsole = false; }
 
@@ -47,6 +53,101 @@ int32 URetargetAll0Commandlet::Main(const FString& Params)
     }
     UE_LOG(RetargetAllCommandlet, Log, TEXT("Using num workers: %d"), NumWorkers);
 
+    // Worker tuning options are passed through unchanged
+    int32 CacheMB = 0;
+    if (FParse::Value(*Params, TEXT("sourcecachemb="), CacheMB)) {
+        WorkerOptions += FString::Printf(TEXT(" -sourcecachemb=%d"), CacheMB);
+    }
+    if (FParse::Value(*Params, TEXT("targetcachemb="), CacheMB)) {
+        WorkerOptions += FString::Printf(TEXT(" -targetcachemb=%d"), CacheMB);
+    }
+    // Options that change the output are also applied here so the manifest fingerprint matches the workers
+    if (FParse::Param(*Params, TEXT("directfbx"))) {
+        WorkerOptions += TEXT(" -directfbx");
+        FRetargeterModule::Get().SetDirectFbxImport(true);
+    }
+    if (FParse::Param(*Params, TEXT("directexport"))) {
+        WorkerOptions += TEXT(" -directexport");
+        FRetargeterModule::Get().SetDirectFbxExport(true);
+    }
+    int32 PipelineDepth = 1;
+    if (FParse::Value(*Params, TEXT("pipelinedepth="), PipelineDepth)) {
+        WorkerOptions += FString::Printf(TEXT(" -pipelinedepth=%d"), PipelineDepth);
+    }
+    int32 FrameChunk = 0, ChunkWarmup = 16;
+    if (FParse::Value(*Params, TEXT("framechunk="), FrameChunk)) {
+        FParse::Value(*Params, TEXT("chunkwarmup="), ChunkWarmup);
+        WorkerOptions += FString::Printf(TEXT(" -framechunk=%d -chunkwarmup=%d"), FrameChunk, ChunkWarmup);
+        FRetargeterModule::Get().SetFrameChunking(FrameChunk, ChunkWarmup);
+    }
+    if (FParse::Param(*Params, TEXT("reducekeys"))) {
+        if (FParse::Param(*Params, TEXT("directexport"))) {
+            WorkerOptions += TEXT(" -reducekeys");
+            FRetargeterModule::Get().SetReduceKeys(true);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("-reducekeys only applies with -directexport, ignoring it"));
+        }
+    }
+    FString Sink, ShardEncoding;
+    if (FParse::Value(*Params, TEXT("sink="), Sink)) {
+        WorkerOptions += FString::Printf(TEXT(" -sink=%s"), *Sink);
+        bShardSink = Sink == TEXT("shard");
+    }
+    if (FParse::Value(*Params, TEXT("shardencoding="), ShardEncoding)) {
+        WorkerOptions += FString::Printf(TEXT(" -shardencoding=%s"), *ShardEncoding);
+    }
+    if (FParse::Value(*Params, TEXT("shardmb="), CacheMB)) {
+        WorkerOptions += FString::Printf(TEXT(" -shardmb=%d"), CacheMB);
+    }
+    // Only workers retarget, and -nocompress does not change outputs, so it is not part of the settings fingerprint
+    if (FParse::Param(*Params, TEXT("nocompress"))) {
+        WorkerOptions += TEXT(" -nocompress");
+    }
+    if (FParse::Param(*Params, TEXT("countallocs"))) {
+        WorkerOptions += TEXT(" -countallocs");
+    }
+    if (FParse::Param(*Params, TEXT("validatesimd"))) {
+        WorkerOptions += TEXT(" -validatesimd");
+    }
+    if (FParse::Param(*Params, TEXT("scalarlocal"))) {
+        WorkerOptions += TEXT(" -scalarlocal");
+    }
+    if (FParse::Param(*Params, TEXT("validatechunks"))) {
+        WorkerOptions += TEXT(" -validatechunks");
+    }
+    int32 GCValue = 0;
+    if (FParse::Value(*Params, TEXT("gcrssmb="), GCValue)) {
+        WorkerOptions += FString::Printf(TEXT(" -gcrssmb=%d"), GCValue);
+    }
+    if (FParse::Value(*Params, TEXT("gcobjects="), GCValue)) {
+        WorkerOptions += FString::Printf(TEXT(" -gcobjects=%d"), GCValue);
+    }
+    if (FParse::Value(*Params, TEXT("gceverypairs="), GCValue)) {
+        WorkerOptions += FString::Printf(TEXT(" -gceverypairs=%d"), GCValue);
+    }
+    // Workers append per-pair metrics under this run name; they are summarized once all workers finish.
+    // Attached daemons get it with the other worker options in every request.
+    if (FParse::Param(*Params, TEXT("metrics"))) {
+        MetricsRun = FDateTime::Now().ToString(TEXT("run_%Y%m%d_%H%M%S"));
+        WorkerOptions += FString::Printf(TEXT(" -metrics=%s"), *MetricsRun);
+    }
+    bAnimationMajor = FParse::Param(*Params, TEXT("animmajor"));
+    if (bAnimationMajor) {
+        WorkerOptions += TEXT(" -animmajor");
+    }
+    FParse::Value(*Params, TEXT("fanout="), FanOut);
+    FanOut = FMath::Max(1, FanOut);
+    FParse::Value(*Params, TEXT("pairsperjob="), PairsPerJob);
+    PairsPerJob = FMath::Max(1, PairsPerJob);
+    bClean = FParse::Param(*Params, TEXT("clean"));
+
+    // Optional: -attach=<sock>,<sock> hands the queue to resident workers started with -serve
+    FString AttachList;
+    if (FParse::Value(*Params, TEXT("attach="), AttachList, /*bShouldStopOnSeparator*/ false)) {
+        AttachList.ParseIntoArray(DaemonSockets, TEXT(","), /*CullEmpty*/ true);
+        UE_LOG(RetargetAllCommandlet, Log, TEXT("Attaching to %d resident workers"), DaemonSockets.Num());
+    }
+
     const FString HomeDir = FPlatformMisc::GetEnvironmentVariable(TEXT("HOME"));
     auto ExpandTilde = [&](FString& InOutPath) {
         if (HomeDir.IsEmpty()) {
@@ -84,8 +185,12 @@ void URetargetAll0Commandlet::RetargetAllInDataset(const FString& BasePath, int3
 {
     TArray<FString> SubDirs = { TEXT("train"), TEXT("val"), TEXT("test") };
 
+    // All splits go into one job stream so a single worker pool runs them without barriers
+    TArray<FRetargetPair> Pairs;
+    int32 NumJobs = 0;
+    int32 NumSkipped = 0;
+    const FString Fingerprint = FRetargeterModule::Get().GetSettingsFingerprint();
     for (const FString& SubDir : SubDirs) {
-        // Clear Retarget directory first
         const FString SubDirPath = FPaths::Combine(BasePath, SubDir);
         if (!FPaths::DirectoryExists(SubDirPath)) {
             UE_LOG(RetargetAllCommandlet, Warning, TEXT("Directory does not exist, skipping: %s"), *SubDirPath);
@@ -93,7 +198,7 @@ void URetargetAll0Commandlet::RetargetAllInDataset(const FString& BasePath, int3
         }
 
         const FString RetargetPath = FPaths::Combine(SubDirPath, TEXT("Retarget"));
-        if (FPaths::DirectoryExists(RetargetPath)) {
+        if (bClean && FPaths::DirectoryExists(RetargetPath)) {
             UE_LOG(RetargetAllCommandlet, Log, TEXT("Clearing existing Retarget directory: %s"), *RetargetPath);
             IFileManager::Get().DeleteDirectory(*RetargetPath, false, true);
         }
@@ -102,60 +207,237 @@ void URetargetAll0Commandlet::RetargetAllInDataset(const FString& BasePath, int3
             continue; // Skip this subdir if we can't create the output folder
         }
 
-        TArray<FProcHandle> WorkerProcesses;
-        UE_LOG(RetargetAllCommandlet, Log, TEXT("Spawning %d workers for directory: %s"), NumWorkers, *SubDir);
+        // Shards are rebuilt as a whole: the manifest only tracks FBX outputs, so every pair is redone
+        if (bShardSink) {
+            UE_LOG(RetargetAllCommandlet, Log, TEXT("Shard output: rebuilding all pairs of %s"), *SubDir);
+            IFileManager::Get().DeleteDirectory(*FPaths::Combine(RetargetPath, TEXT("shards")), false, true);
+        }
+
+        // The subset per skeleton only depends on the split seed
+        const int32 SplitSeed = MainSeed + GetTypeHash(SubDir) % 1000;
+        const int32 NumJobsBefore = NumJobs;
+        TArray<FRetargetPair> SplitPairs;
+        if (SubDir == TEXT("train")) {
+            BuildTrainPairs(SubDirPath, SplitSeed, NumJobs, SplitPairs);
+        } else {
+            BuildTestValPairs(SubDirPath, NumJobs, SplitPairs);
+        }
+
+        // Outputs of pairs no longer scheduled (changed seed, removed inputs) are deleted, then the shards
+        // left by the previous run are merged before new workers start appending
+        TSet<FString> ScheduledNames;
+        for (const FRetargetPair& Pair : SplitPairs) {
+            ScheduledNames.Add(FPaths::GetCleanFilename(Pair.OutputFile));
+        }
+        FRetargetManifest Manifest;
+        Manifest.Load(RetargetPath);
+        const int32 NumPruned = Manifest.Prune(RetargetPath, ScheduledNames);
+        if (NumPruned > 0) {
+            UE_LOG(RetargetAllCommandlet, Log, TEXT("Deleted %d outputs no longer scheduled in %s"), NumPruned, *SubDir);
+        }
+        Manifest.Compact(RetargetPath);
+
+        // Pairs whose inputs, settings and output are unchanged are left out; emptied jobs are skipped by workers
+        int32 NumQueued = 0;
+        for (FRetargetPair& Pair : SplitPairs) {
+            Pair.Key = FRetargetManifest::MakePairKey(
+                GetFileHash(Pair.AnimationFile), GetFileHash(Pair.SkeletonFile), Fingerprint);
+            if (!bShardSink && Manifest.IsUpToDate(Pair.OutputFile, Pair.Key)) {
+                ++NumSkipped;
+                continue;
+            }
+            Pairs.Add(MoveTemp(Pair));
+            ++NumQueued;
+        }
+        UE_LOG(RetargetAllCommandlet, Log, TEXT("Queued %d of %d pairs in %d jobs for %s"), NumQueued,
+            SplitPairs.Num(), NumJobs - NumJobsBefore, *SubDir);
+    }
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Skipped %d up-to-date pairs"), NumSkipped);
+
+    if (Pairs.Num() == 0) {
+        UE_LOG(RetargetAllCommandlet, Warning, TEXT("No pairs to retarget in %s"), *BasePath);
+        return;
+    }
+
+    const FString QueueName = FString::Printf(TEXT("queue_%d"), FPlatformProcess::GetCurrentProcessId());
+    const FString QueueDir
+        = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved/Workers/"), QueueName));
+    if (!FRetargetWorkQueue::Write(QueueDir, Pairs)) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to write work queue: %s"), *QueueDir);
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    if (DaemonSockets.Num() > 0) {
+        RunQueueOnDaemons(QueueDir);
+        FRetargetWorkQueue::Remove(QueueDir);
+        UE_LOG(RetargetAllCommandlet, Log, TEXT("All subdirectories processed."));
+        LogRunMetrics(StartTime);
+        return;
+    }
+
+    TArray<FProcHandle> WorkerProcesses;
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Spawning %d workers for %d jobs"), NumWorkers, NumJobs);
+
+    for (int32 i = 0; i < NumWorkers; ++i) {
+        FString EditorExe = FPlatformProcess::GetApplicationName(FPlatformProcess::GetCurrentProcessId());
+        FString ProjectPath = FPaths::GetProjectFilePath();
+
+        const FString Suffix = FString::Printf(TEXT("%d_%d"), i, FPlatformProcess::GetCurrentProcessId());
+        const FString UserDir = FPaths::ConvertRelativePathToFull(
+            FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved/Workers/"), Suffix));
+        IFileManager::Get().MakeDirectory(*UserDir, /*Tree*/ true);
+
+        FString LogFile = FPaths::ConvertRelativePathToFull(FPaths::Combine(
+            FPaths::ProjectDir(), TEXT("Saved/Logs/"), FString::Printf(TEXT("worker_%d.log"), i)));
+
+        FString Args = FString::Printf(
+            TEXT("\"%s\" -run=RetargetWorker -queue=\"%s\" -workerindex=%d -numworkers=%d ")
+                TEXT("-abslog=\"%s\" -UserDir=\"%s\" -retarget_session_suffix=\"%s\" ")
+                    TEXT("-LogCmds=\"global off, log RetargetAllCommandlet verbose\" -NoStdOut --stdout -NOCONSOLE "
+                         "-unattended%s"),
+            *ProjectPath, *QueueDir, i, NumWorkers, *LogFile, *UserDir, *Suffix, *WorkerOptions);
+
+        UE_LOG(RetargetAllCommandlet, Log, TEXT("Launching worker %d with args: %s"), i, *Args);
+
+        FProcHandle ProcHandle
+            = FPlatformProcess::CreateProc(*EditorExe, *Args, true, false, false, nullptr, 0, nullptr, nullptr);
+        if (ProcHandle.IsValid()) {
+            WorkerProcesses.Add(ProcHandle);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to launch worker process %d"), i);
+        }
+    }
+
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Waiting for %d worker processes to complete..."), WorkerProcesses.Num());
+
+    for (FProcHandle& ProcHandle : WorkerProcesses) {
+        FPlatformProcess::WaitForProc(ProcHandle);
+        int32 ReturnCode;
+        if (FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode)) {
+            UE_LOG(RetargetAllCommandlet, Log, TEXT("Worker process finished with exit code %d"), ReturnCode);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("Could not get return code for a worker process."));
+        }
+        FPlatformProcess::CloseProc(ProcHandle);
+    }
+    FRetargetWorkQueue::Remove(QueueDir);
+
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("All subdirectories processed."));
+    LogRunMetrics(StartTime);
+}
+
+void URetargetAll0Commandlet::LogRunMetrics(double StartTime)
+{
+    if (MetricsRun.IsEmpty()) {
+        return;
+    }
+    const FString Summary = RetargetMetrics::SummarizeRun(MetricsRun, FPlatformTime::Seconds() - StartTime);
+    if (Summary.IsEmpty()) {
+        UE_LOG(RetargetAllCommandlet, Warning, TEXT("No pair metrics found for %s"), *MetricsRun);
+        return;
+    }
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Run metrics for %s: %s"), *MetricsRun, *Summary);
+}
 
-        for (int32 i = 0; i < NumWorkers; ++i) {
-            FString EditorExe = FPlatformProcess::GetApplicationName(FPlatformProcess::GetCurrentProcessId());
-            FString ProjectPath = FPaths::GetProjectFilePath();
+void URetargetAll0Commandlet::RunQueueOnDaemons(const FString& QueueDir)
+{
+    // Send the queue to every daemon first so they all run concurrently, then wait for the replies
+    // Daemons take this run's worker options so their outputs match the manifest fingerprints
+    TArray<TUniquePtr<FRetargetLineSocket>> Connections;
+    for (int32 i = 0; i < DaemonSockets.Num(); ++i) {
+        TUniquePtr<FRetargetLineSocket> Socket = MakeUnique<FRetargetLineSocket>();
+        TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+        Json->SetStringField(TEXT("cmd"), TEXT("queue"));
+        Json->SetStringField(TEXT("path"), QueueDir);
+        Json->SetNumberField(TEXT("workerindex"), i);
+        Json->SetNumberField(TEXT("numworkers"), DaemonSockets.Num());
+        Json->SetStringField(TEXT("options"), WorkerOptions);
+        FString Request;
+        FJsonSerializer::Serialize(Json, TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Request));
+        if (Socket->Connect(DaemonSockets[i]) && Socket->WriteLine(Request)) {
+            UE_LOG(RetargetAllCommandlet, Log, TEXT("Queue sent to resident worker %s"), *DaemonSockets[i]);
+            Connections.Add(MoveTemp(Socket));
+        } else {
+            UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to send queue to resident worker %s"), *DaemonSockets[i]);
+        }
+    }
 
-            const FString Suffix
-                = FString::Printf(TEXT("%s_%d_%d"), *SubDir, i, FPlatformProcess::GetCurrentProcessId());
-            const FString UserDir = FPaths::ConvertRelativePathToFull(
-                FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved/Workers/"), Suffix));
-            IFileManager::Get().MakeDirectory(*UserDir, /*Tree*/ true);
+    for (TUniquePtr<FRetargetLineSocket>& Socket : Connections) {
+        FString Reply;
+        if (Socket->ReadLine(Reply)) {
+            UE_LOG(RetargetAllCommandlet, Log, TEXT("Resident worker finished: %s"), *Reply);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("Lost connection to a resident worker"));
+        }
+    }
+}
 
-            FString LogFile = FPaths::ConvertRelativePathToFull(FPaths::Combine(
-                FPaths::ProjectDir(), TEXT("Saved/Logs/"), FString::Printf(TEXT("worker_%s_%d.log"), *SubDir, i)));
+void URetargetAll0Commandlet::BuildTrainPairs(
+    const FString& TrainPath, int32 SplitSeed, int32& InOutNumJobs, TArray<FRetargetPair>& OutPairs)
+{
+    const FString CharacterPath = FPaths::Combine(TrainPath, TEXT("Character"));
+    const FString AnimationPath = FPaths::Combine(TrainPath, TEXT("Animation"));
+    const FString RetargetPath = FPaths::Combine(TrainPath, TEXT("Retarget"));
 
-            // Generate unique seed for this worker using main seed and worker index
-            int32 WorkerSeed = MainSeed + (i * 1000) + GetTypeHash(SubDir) % 1000;
+    TArray<FString> SkeletonFiles = RetargetCommandlet::GetFBXFiles(CharacterPath);
+    TArray<FString> AnimationFiles = RetargetCommandlet::GetFBXFiles(AnimationPath);
 
-            FString Args = FString::Printf(
-                TEXT("\"%s\" -run=RetargetWorker -input=\"%s\" -subdir=%s -workerindex=%d -numworkers=%d -seed=%d ")
-                    TEXT("-abslog=\"%s\" -UserDir=\"%s\" -retarget_session_suffix=\"%s\" ")
-                        TEXT("-LogCmds=\"global off, log RetargetAllCommandlet verbose\" -NoStdOut --stdout -NOCONSOLE "
-                             "-unattended"),
-                *ProjectPath, *BasePath, *SubDir, i, NumWorkers, WorkerSeed, *LogFile, *UserDir, *Suffix);
+    const int32 MaxAnimations = FMath::Min(100, AnimationFiles.Num());
+    for (int32 SkeletonIdx = 0; SkeletonIdx < SkeletonFiles.Num(); ++SkeletonIdx) {
+        const FString& SkeletonFile = SkeletonFiles[SkeletonIdx];
+        const FString SkeletonName = FPaths::GetBaseFilename(SkeletonFile);
 
-            UE_LOG(RetargetAllCommandlet, Log, TEXT("Launching worker %d for %s with args: %s"), i, *SubDir, *Args);
+        // Seeded per skeleton so the subset does not depend on which worker processes it
+        TArray<FString> RandomAnimations
+            = RetargetCommandlet::GetRandomSubset(AnimationFiles, MaxAnimations, SplitSeed + SkeletonIdx);
 
-            FProcHandle ProcHandle
-                = FPlatformProcess::CreateProc(*EditorExe, *Args, true, false, false, nullptr, 0, nullptr, nullptr);
-            if (ProcHandle.IsValid()) {
-                WorkerProcesses.Add(ProcHandle);
-            } else {
-                UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to launch worker process %d for %s"), i, *SubDir);
+        // Jobs keep one skeleton so the worker's target cache is reused within the job
+        for (int32 i = 0; i < RandomAnimations.Num(); ++i) {
+            if (i % PairsPerJob == 0) {
+                ++InOutNumJobs;
             }
+            const FString AnimationName = FPaths::GetBaseFilename(RandomAnimations[i]);
+            const FString PrefixedName = SkeletonName + TEXT("__") + AnimationName + TEXT(".fbx");
+            OutPairs.Add({ InOutNumJobs - 1, RandomAnimations[i], SkeletonFile,
+                FPaths::Combine(RetargetPath, PrefixedName) });
         }
+    }
+}
+
+void URetargetAll0Commandlet::BuildTestValPairs(
+    const FString& DirPath, int32& InOutNumJobs, TArray<FRetargetPair>& OutPairs)
+{
+    const FString CharacterPath = FPaths::Combine(DirPath, TEXT("Character"));
+    const FString AnimationPath = FPaths::Combine(DirPath, TEXT("Animation"));
+    const FString RetargetPath = FPaths::Combine(DirPath, TEXT("Retarget"));
 
-        UE_LOG(RetargetAllCommandlet, Log, TEXT("Waiting for %d worker processes for %s to complete..."),
-            WorkerProcesses.Num(), *SubDir);
+    TArray<FString> SkeletonFiles = RetargetCommandlet::GetFBXFiles(CharacterPath);
+    TArray<FString> AnimationFiles = RetargetCommandlet::GetFBXFiles(AnimationPath);
 
-        for (FProcHandle& ProcHandle : WorkerProcesses) {
-            FPlatformProcess::WaitForProc(ProcHandle);
-            int32 ReturnCode;
-            if (FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode)) {
-                UE_LOG(RetargetAllCommandlet, Log, TEXT("Worker process for %s finished with exit code %d"), *SubDir,
-                    ReturnCode);
-            } else {
-                UE_LOG(RetargetAllCommandlet, Warning, TEXT("Could not get return code for a worker process for %s."),
-                    *SubDir);
+    // Animation-major jobs share one source across up to FanOut skeletons, otherwise one skeleton
+    // across up to PairsPerJob animations
+    const int32 NumOuter = bAnimationMajor ? AnimationFiles.Num() : SkeletonFiles.Num();
+    const int32 NumInner = bAnimationMajor ? SkeletonFiles.Num() : AnimationFiles.Num();
+    const int32 JobSize = bAnimationMajor ? FanOut : PairsPerJob;
+    for (int32 Outer = 0; Outer < NumOuter; ++Outer) {
+        for (int32 Inner = 0; Inner < NumInner; ++Inner) {
+            if (Inner % JobSize == 0) {
+                ++InOutNumJobs;
             }
-            FPlatformProcess::CloseProc(ProcHandle);
+            const FString& AnimationFile = bAnimationMajor ? AnimationFiles[Outer] : AnimationFiles[Inner];
+            const FString& SkeletonFile = bAnimationMajor ? SkeletonFiles[Inner] : SkeletonFiles[Outer];
+            const FString PrefixedName
+                = FPaths::GetBaseFilename(SkeletonFile) + TEXT("__") + FPaths::GetBaseFilename(AnimationFile) + TEXT(".fbx");
+            OutPairs.Add({ InOutNumJobs - 1, AnimationFile, SkeletonFile, FPaths::Combine(RetargetPath, PrefixedName) });
         }
-        UE_LOG(RetargetAllCommandlet, Log, TEXT("All workers for %s finished."), *SubDir);
     }
+}
 
-    UE_LOG(RetargetAllCommandlet, Log, TEXT("All subdirectories processed."));
+FString URetargetAll0Commandlet::GetFileHash(const FString& FilePath)
+{
+    if (const FString* Hash = FileHashes.Find(FilePath)) {
+        return *Hash;
+    }
+    return FileHashes.Add(FilePath, FRetargetManifest::HashFile(FilePath));
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Commandlets/Commandlet.h"
+#include "RetargetWorkQueue.h"
 #include "RetargetAll0Commandlet.generated.h"
 
 /**
@@ -23,8 +24,30 @@ public:
 
 private:
 	void RetargetAllInDataset(const FString& BasePath, int32 MainSeed, int32 NumWorkers);
-	void ProcessTrainDirectory(const FString& TrainPath);
-	void ProcessTestValDirectory(const FString& DirPath, const FString& DirName);
-	TArray<FString> GetFBXFiles(const FString& DirectoryPath);
-	TArray<FString> GetRandomSubset(const TArray<FString>& InputArray, int32 Count);
+	void RunQueueOnDaemons(const FString& QueueDir);
+	void LogRunMetrics(double StartTime);
+	void BuildTrainPairs(const FString& TrainPath, int32 SplitSeed, int32& InOutNumJobs, TArray<FRetargetPair>& OutPairs);
+	void BuildTestValPairs(const FString& DirPath, int32& InOutNumJobs, TArray<FRetargetPair>& OutPairs);
+	FString GetFileHash(const FString& FilePath);
+
+	// Options forwarded verbatim to every worker process
+	FString WorkerOptions;
+
+	// Sockets of resident workers (-attach=) used instead of spawning new ones
+	TArray<FString> DaemonSockets;
+
+	// Job grouping of the shared pair queue
+	bool bAnimationMajor = false;
+	int32 FanOut = 8;
+	int32 PairsPerJob = 10;
+
+	// -clean deletes Retarget directories instead of skipping pairs recorded in their manifest
+	bool bClean = false;
+
+	// -sink=shard: workers write binary shards instead of FBX files. Shards are not tracked by the manifest,
+	// so they are deleted and every pair is redone on each run.
+	bool bShardSink = false;
+	// Metrics run name passed to workers with -metrics, empty when disabled
+	FString MetricsRun;
+	TMap<FString, FString> FileHashes;
 };
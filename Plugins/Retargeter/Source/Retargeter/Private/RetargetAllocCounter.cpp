@@ -0,0 +1,65 @@
+#include "RetargetAllocCounter.h"
+
+namespace {
+thread_local uint64 ThreadAllocs = 0;
+FRetargetAllocCounter* Installed = nullptr;
+} // namespace
+
+void FRetargetAllocCounter::Install()
+{
+    if (!Installed) {
+        Installed = new FRetargetAllocCounter(GMalloc);
+        GMalloc = Installed;
+    }
+}
+
+bool FRetargetAllocCounter::IsInstalled() { return Installed != nullptr; }
+
+uint64 FRetargetAllocCounter::GetThreadAllocs() { return ThreadAllocs; }
+
+void* FRetargetAllocCounter::Malloc(SIZE_T Count, uint32 Alignment)
+{
+    ++ThreadAllocs;
+    return Inner->Malloc(Count, Alignment);
+}
+
+void* FRetargetAllocCounter::TryMalloc(SIZE_T Count, uint32 Alignment)
+{
+    ++ThreadAllocs;
+    return Inner->TryMalloc(Count, Alignment);
+}
+
+void* FRetargetAllocCounter::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+    ++ThreadAllocs;
+    return Inner->Realloc(Original, Count, Alignment);
+}
+
+void* FRetargetAllocCounter::TryRealloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+    ++ThreadAllocs;
+    return Inner->TryRealloc(Original, Count, Alignment);
+}
+
+void FRetargetAllocCounter::Free(void* Original) { Inner->Free(Original); }
+
+SIZE_T FRetargetAllocCounter::QuantizeSize(SIZE_T Count, uint32 Alignment)
+{
+    return Inner->QuantizeSize(Count, Alignment);
+}
+
+bool FRetargetAllocCounter::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+    return Inner->GetAllocationSize(Original, SizeOut);
+}
+
+void FRetargetAllocCounter::Trim(bool bTrimThreadCaches) { Inner->Trim(bTrimThreadCaches); }
+
+void FRetargetAllocCounter::SetupTLSCachesOnCurrentThread() { Inner->SetupTLSCachesOnCurrentThread(); }
+
+void FRetargetAllocCounter::ClearAndDisableTLSCachesOnCurrentThread()
+{
+    Inner->ClearAndDisableTLSCachesOnCurrentThread();
+}
+
+bool FRetargetAllocCounter::IsInternallyThreadSafe() const { return Inner->IsInternallyThreadSafe(); }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/**
+ * Debug malloc proxy that counts heap allocations made by the calling thread.
+ * Installed once with -countallocs; every call is forwarded to the original allocator.
+ */
+class FRetargetAllocCounter : public FMalloc {
+public:
+    static void Install();
+    static bool IsInstalled();
+
+    // Allocations (malloc and realloc) made by this thread since it started
+    static uint64 GetThreadAllocs();
+
+    virtual void* Malloc(SIZE_T Count, uint32 Alignment) override;
+    virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override;
+    virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+    virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+    virtual void Free(void* Original) override;
+    virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override;
+    virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+    virtual void Trim(bool bTrimThreadCaches) override;
+    virtual void SetupTLSCachesOnCurrentThread() override;
+    virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
+    virtual bool IsInternallyThreadSafe() const override;
+    virtual const TCHAR* GetDescriptiveName() override { return TEXT("RetargetAllocCounter"); }
+
+private:
+    explicit FRetargetAllocCounter(FMalloc* InInner)
+        : Inner(InInner)
+    {
+    }
+
+    FMalloc* Inner;
+};
@@ -0,0 +1,97 @@
+#include "RetargetAssetCache.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/SkeletalMesh.h"
+#include "IKRig/Public/Rig/IKRigDefinition.h"
+#include "RetargetFbx.h"
+
+namespace {
+void SetRooted(UObject* Obj, bool bRooted)
+{
+    if (!Obj) {
+        return;
+    }
+    if (bRooted) {
+        Obj->AddToRoot();
+    } else {
+        Obj->RemoveFromRoot();
+    }
+}
+
+void SetEntryRooted(const FRetargetCachedAssets& Entry, bool bRooted)
+{
+    SetRooted(Entry.Animation, bRooted);
+    SetRooted(Entry.Mesh, bRooted);
+    SetRooted(Entry.IKRig, bRooted);
+}
+} // namespace
+
+void FRetargetAssetCache::SetBudgetBytes(int64 InBudgetBytes) { BudgetBytes = FMath::Max<int64>(0, InBudgetBytes); }
+
+FRetargetCachedAssets* FRetargetAssetCache::Find(const FString& FbxPath)
+{
+    const int32 Index = Entries.IndexOfByPredicate(
+        [&FbxPath](const FRetargetCachedAssets& Entry) { return Entry.FbxPath == FbxPath; });
+    if (Index == INDEX_NONE) {
+        return nullptr;
+    }
+    if (Index != Entries.Num() - 1) {
+        FRetargetCachedAssets Entry = MoveTemp(Entries[Index]);
+        Entries.RemoveAt(Index);
+        Entries.Add(MoveTemp(Entry));
+    }
+    return &Entries.Last();
+}
+
+void FRetargetAssetCache::Add(FRetargetCachedAssets&& Entry, TArray<FRetargetCachedAssets>& OutEvicted)
+{
+    Entry.SizeBytes = 0;
+    if (Entry.Animation) {
+        Entry.SizeBytes += Entry.Animation->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+    }
+    if (Entry.Mesh) {
+        Entry.SizeBytes += Entry.Mesh->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+    }
+    if (Entry.Clip) {
+        Entry.SizeBytes += Entry.Clip->LocalPoses.GetAllocatedSize();
+    }
+    SetEntryRooted(Entry, true);
+    TotalBytes += Entry.SizeBytes;
+    Entries.Add(MoveTemp(Entry));
+    Trim(OutEvicted);
+}
+
+void FRetargetAssetCache::Trim(TArray<FRetargetCachedAssets>& OutEvicted)
+{
+    while (Entries.Num() > 1 && TotalBytes > BudgetBytes) {
+        Evict(0, OutEvicted);
+    }
+}
+
+void FRetargetAssetCache::SetIKRig(const FString& FbxPath, UIKRigDefinition* IKRig)
+{
+    for (FRetargetCachedAssets& Entry : Entries) {
+        if (Entry.FbxPath == FbxPath) {
+            SetRooted(Entry.IKRig, false);
+            Entry.IKRig = IKRig;
+            SetRooted(Entry.IKRig, true);
+            return;
+        }
+    }
+}
+
+void FRetargetAssetCache::Empty(TArray<FRetargetCachedAssets>& OutEvicted)
+{
+    while (Entries.Num() > 0) {
+        Evict(0, OutEvicted);
+    }
+    TotalBytes = 0;
+}
+
+void FRetargetAssetCache::Evict(int32 Index, TArray<FRetargetCachedAssets>& OutEvicted)
+{
+    FRetargetCachedAssets Entry = MoveTemp(Entries[Index]);
+    Entries.RemoveAt(Index);
+    SetEntryRooted(Entry, false);
+    TotalBytes -= Entry.SizeBytes;
+    OutEvicted.Add(MoveTemp(Entry));
+}
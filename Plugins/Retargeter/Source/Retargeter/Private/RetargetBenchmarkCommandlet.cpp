@@ -0,0 +1,491 @@
+#include "RetargetBenchmarkCommandlet.h"
+#include "Animation/AnimSequence.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Logging/LogScopedVerbosityOverride.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RetargetCommandletShared.h"
+#include "RetargetFbx.h"
+#include "RetargetMetrics.h"
+#include "RetargetSimd.h"
+#include "Retargeter.h"
+#include "RetargeterLog.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace {
+struct FHumanoidBone {
+    const TCHAR* Name;
+    const TCHAR* Parent;
+    FVector Offset;
+    // Arm and leg bones are stretched by the limb scale
+    bool bLimb;
+};
+
+// Standard names without prefixes, as GenerateRetargetChains expects. Parents come first.
+// The root offset is computed from the leg length.
+const FHumanoidBone HumanoidBones[] = {
+    { TEXT("Hips"), nullptr, FVector::ZeroVector, false },
+    { TEXT("Spine"), TEXT("Hips"), FVector(0, 0, 10), false },
+    { TEXT("Spine1"), TEXT("Spine"), FVector(0, 0, 12), false },
+    { TEXT("Spine2"), TEXT("Spine1"), FVector(0, 0, 12), false },
+    { TEXT("Neck"), TEXT("Spine2"), FVector(0, 0, 16), false },
+    { TEXT("Head"), TEXT("Neck"), FVector(0, 0, 10), false },
+    { TEXT("LeftShoulder"), TEXT("Spine2"), FVector(0, -6, 12), false },
+    { TEXT("LeftArm"), TEXT("LeftShoulder"), FVector(0, -12, 0), true },
+    { TEXT("LeftForeArm"), TEXT("LeftArm"), FVector(0, -26, 0), true },
+    { TEXT("LeftHand"), TEXT("LeftForeArm"), FVector(0, -24, 0), true },
+    { TEXT("RightShoulder"), TEXT("Spine2"), FVector(0, 6, 12), false },
+    { TEXT("RightArm"), TEXT("RightShoulder"), FVector(0, 12, 0), true },
+    { TEXT("RightForeArm"), TEXT("RightArm"), FVector(0, 26, 0), true },
+    { TEXT("RightHand"), TEXT("RightForeArm"), FVector(0, 24, 0), true },
+    { TEXT("LeftUpLeg"), TEXT("Hips"), FVector(0, -9, -5), false },
+    { TEXT("LeftLeg"), TEXT("LeftUpLeg"), FVector(0, 0, -42), true },
+    { TEXT("LeftFoot"), TEXT("LeftLeg"), FVector(0, 0, -40), true },
+    { TEXT("RightUpLeg"), TEXT("Hips"), FVector(0, 9, -5), false },
+    { TEXT("RightLeg"), TEXT("RightUpLeg"), FVector(0, 0, -42), true },
+    { TEXT("RightFoot"), TEXT("RightLeg"), FVector(0, 0, -40), true },
+};
+
+// Bones that receive extra "_added" bones, handed out in this order
+const TCHAR* const AddedBoneSlots[] = { TEXT("Spine"), TEXT("Neck"), TEXT("LeftArm"), TEXT("RightArm"),
+    TEXT("LeftUpLeg"), TEXT("RightUpLeg"), TEXT("LeftForeArm"), TEXT("RightForeArm"), TEXT("LeftLeg"),
+    TEXT("RightLeg") };
+
+template <typename T> T GetPadded(const TArray<T>& Values, int32 Index)
+{
+    return Values[FMath::Min(Index, Values.Num() - 1)];
+}
+
+void ParseList(const FString& List, TArray<int32>& OutValues)
+{
+    TArray<FString> Items;
+    List.ParseIntoArray(Items, TEXT(","));
+    OutValues.Reset();
+    for (const FString& Item : Items) {
+        OutValues.Add(FCString::Atoi(*Item));
+    }
+}
+
+void ParseList(const FString& List, TArray<float>& OutValues)
+{
+    TArray<FString> Items;
+    List.ParseIntoArray(Items, TEXT(","));
+    OutValues.Reset();
+    for (const FString& Item : Items) {
+        OutValues.Add(FCString::Atof(*Item));
+    }
+}
+
+template <typename T> TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<T>& Values)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    for (const T Value : Values) {
+        Array.Add(MakeShared<FJsonValueNumber>(Value));
+    }
+    return Array;
+}
+
+// Added bones sit at their parent's position, between the parent and the bone they were added for
+void MakeHumanoid(int32 NumExtraBones, float Scale, float LimbScale, FReferenceSkeleton& OutSkeleton)
+{
+    TMap<FString, int32> NumAdded;
+    for (int32 Index = 0; Index < NumExtraBones; ++Index) {
+        NumAdded.FindOrAdd(AddedBoneSlots[Index % UE_ARRAY_COUNT(AddedBoneSlots)])++;
+    }
+
+    OutSkeleton.Empty();
+    FReferenceSkeletonModifier Modifier(OutSkeleton, nullptr);
+    TMap<FString, int32> BoneIndices;
+    int32 NumBones = 0;
+    for (const FHumanoidBone& Bone : HumanoidBones) {
+        int32 ParentIndex = Bone.Parent ? BoneIndices.FindChecked(Bone.Parent) : INDEX_NONE;
+        for (int32 Index = 0; Index < NumAdded.FindRef(Bone.Name); ++Index) {
+            const FName AddedName(*FString::Printf(TEXT("%s_added_%d"), *FString(Bone.Name).ToLower(), Index));
+            Modifier.Add(FMeshBoneInfo(AddedName, AddedName.ToString(), ParentIndex), FTransform::Identity);
+            ParentIndex = NumBones++;
+        }
+
+        const FVector Offset = Bone.Parent ? Bone.Offset * (Bone.bLimb ? LimbScale : 1.f) * Scale
+                                           : FVector(0, 0, (13.f + 82.f * LimbScale) * Scale);
+        Modifier.Add(FMeshBoneInfo(FName(Bone.Name), Bone.Name, ParentIndex), FTransform(Offset));
+        BoneIndices.Add(Bone.Name, NumBones++);
+    }
+}
+
+// Every bone but the added ones swings around a random axis; the root also walks forward.
+// A single frame gives the reference pose.
+void MakeMotion(const FReferenceSkeleton& RefSkeleton, int32 NumFrames, const FFrameRate& FrameRate,
+    FRandomStream& Random, TArray<FRawAnimSequenceTrack>& OutTracks)
+{
+    const TArray<FTransform>& RefPose = RefSkeleton.GetRawRefBonePose();
+    OutTracks.SetNum(RefPose.Num());
+    for (int32 BoneIndex = 0; BoneIndex < RefPose.Num(); ++BoneIndex) {
+        const bool bAnimated
+            = NumFrames > 1 && !RefSkeleton.GetBoneName(BoneIndex).ToString().Contains(TEXT("_added"));
+        const FVector Axis = Random.GetUnitVector();
+        const float Amplitude = FMath::DegreesToRadians(Random.FRandRange(5.f, 35.f));
+        const float Frequency = Random.FRandRange(0.3f, 1.5f);
+        const float Phase = Random.FRandRange(0.f, UE_TWO_PI);
+
+        FRawAnimSequenceTrack& Track = OutTracks[BoneIndex];
+        Track.PosKeys.SetNum(NumFrames);
+        Track.RotKeys.SetNum(NumFrames);
+        Track.ScaleKeys.SetNum(NumFrames);
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame) {
+            const float Time = FrameRate.AsSeconds(FFrameTime(Frame));
+            FTransform Local = RefPose[BoneIndex];
+            if (bAnimated) {
+                const float Angle = Amplitude * FMath::Sin(UE_TWO_PI * Frequency * Time + Phase);
+                Local.SetRotation(Local.GetRotation() * FQuat(Axis, Angle));
+                if (BoneIndex == 0) {
+                    Local.AddToTranslation(FVector(150.f * Time, 0, 3.f * FMath::Sin(2.f * UE_TWO_PI * Time)));
+                }
+            }
+            Track.PosKeys[Frame] = FVector3f(Local.GetTranslation());
+            Track.RotKeys[Frame] = FQuat4f(Local.GetRotation());
+            Track.ScaleKeys[Frame] = FVector3f(Local.GetScale3D());
+        }
+    }
+}
+
+// Largest relative difference between two clips of the same shape; rotations are compared up to sign
+float MaxClipError(const FRetargetFbxClip& A, const FRetargetFbxClip& B)
+{
+    auto RelativeError = [](double X, double Y) { return float(FMath::Abs(X - Y) / FMath::Max(1.0, FMath::Abs(Y))); };
+    float MaxError = 0.f;
+    for (int32 Index = 0; Index < A.LocalPoses.Num(); ++Index) {
+        const FTransform& PoseA = A.LocalPoses[Index];
+        const FTransform& PoseB = B.LocalPoses[Index];
+        for (int32 Axis = 0; Axis < 3; ++Axis) {
+            MaxError = FMath::Max(MaxError, RelativeError(PoseA.GetTranslation()[Axis], PoseB.GetTranslation()[Axis]));
+            MaxError = FMath::Max(MaxError, RelativeError(PoseA.GetScale3D()[Axis], PoseB.GetScale3D()[Axis]));
+        }
+        const FQuat QA = PoseA.GetRotation();
+        const FQuat QB = (QA | PoseB.GetRotation()) < 0.0 ? PoseB.GetRotation() * -1.0 : PoseB.GetRotation();
+        MaxError = FMath::Max(MaxError, RelativeError(QA.X, QB.X));
+        MaxError = FMath::Max(MaxError, RelativeError(QA.Y, QB.Y));
+        MaxError = FMath::Max(MaxError, RelativeError(QA.Z, QB.Z));
+        MaxError = FMath::Max(MaxError, RelativeError(QA.W, QB.W));
+    }
+    return MaxError;
+}
+
+// Metrics summary of a run (see RetargetMetrics::SummarizeRun)
+TSharedPtr<FJsonObject> SummarizeBenchmarkRun(const FString& Run, double WallSeconds)
+{
+    TSharedPtr<FJsonObject> Summary;
+    const FString Json = RetargetMetrics::SummarizeRun(Run, WallSeconds);
+    if (Json.IsEmpty() || !FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(Json), Summary)
+        || !Summary) {
+        UE_LOG(RetargetAllCommandlet, Warning, TEXT("Benchmark: no pair metrics recorded for %s"), *Run);
+        Summary = MakeShared<FJsonObject>();
+        Summary->SetNumberField(TEXT("pairs"), 0);
+        Summary->SetNumberField(TEXT("wall_sec"), WallSeconds);
+    }
+    return Summary;
+}
+} // namespace
+
+URetargetBenchmarkCommandlet::URetargetBenchmarkCommandlet() { LogToConsole = false; }
+
+int32 URetargetBenchmarkCommandlet::Main(const FString& Params)
+{
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("---Retarget benchmark---"));
+
+    // Skeleton variants: -extrabones=0,8,24 -scales=1,0.8,1.25 -limbscales=1,1.15,0.9; clips: -frames=120,1200
+    ExtraBones = { 0, 8, 24 };
+    Scales = { 1.f, 0.8f, 1.25f };
+    LimbScales = { 1.f, 1.15f, 0.9f };
+    ClipFrames = { 120, 1200 };
+    FString List;
+    if (FParse::Value(*Params, TEXT("extrabones="), List)) {
+        ParseList(List, ExtraBones);
+    }
+    if (FParse::Value(*Params, TEXT("scales="), List)) {
+        ParseList(List, Scales);
+    }
+    if (FParse::Value(*Params, TEXT("limbscales="), List)) {
+        ParseList(List, LimbScales);
+    }
+    if (FParse::Value(*Params, TEXT("frames="), List)) {
+        ParseList(List, ClipFrames);
+    }
+    if (ExtraBones.Num() == 0 || Scales.Num() == 0 || LimbScales.Num() == 0 || ClipFrames.Num() == 0) {
+        UE_LOG(RetargetAllCommandlet, Error,
+            TEXT("Benchmark: -extrabones, -scales, -limbscales and -frames need values"));
+        return 1;
+    }
+    FParse::Value(*Params, TEXT("seed="), Seed);
+    FParse::Value(*Params, TEXT("repeat="), Repeat);
+    FParse::Value(*Params, TEXT("workers="), NumWorkers);
+    FParse::Value(*Params, TEXT("pairsperjob="), PairsPerJob);
+    Repeat = FMath::Max(1, Repeat);
+    PairsPerJob = FMath::Max(1, PairsPerJob);
+
+    // Synthetic files have no mesh, so they are always read directly
+    FRetargeterModule& Retargeter = FRetargeterModule::Get();
+    Retargeter.SetDirectFbxImport(true);
+    WorkerOptions = TEXT(" -directfbx");
+    if (FParse::Param(*Params, TEXT("directexport"))) {
+        WorkerOptions += TEXT(" -directexport");
+        Retargeter.SetDirectFbxExport(true);
+    }
+    if (FParse::Param(*Params, TEXT("reducekeys"))) {
+        if (FParse::Param(*Params, TEXT("directexport"))) {
+            WorkerOptions += TEXT(" -reducekeys");
+            Retargeter.SetReduceKeys(true);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Warning,
+                TEXT("Benchmark: -reducekeys only applies with -directexport, ignoring it"));
+        }
+    }
+    const bool bNoCompress = FParse::Param(*Params, TEXT("nocompress"));
+    if (bNoCompress) {
+        WorkerOptions += TEXT(" -nocompress");
+        Retargeter.SetSkipCompression(true);
+    }
+    int32 PipelineDepth = 1;
+    if (FParse::Value(*Params, TEXT("pipelinedepth="), PipelineDepth)) {
+        WorkerOptions += FString::Printf(TEXT(" -pipelinedepth=%d"), PipelineDepth);
+        Retargeter.SetPipelineDepth(PipelineDepth);
+    }
+
+    BenchmarkName = FDateTime::Now().ToString(TEXT("bench_%Y%m%d_%H%M%S"));
+    FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmark"), BenchmarkName);
+    FParse::Value(*Params, TEXT("output="), OutputDir);
+    OutputDir = FPaths::ConvertRelativePathToFull(OutputDir);
+
+    if (!GenerateInputs(FPaths::Combine(OutputDir, TEXT("Input")))) {
+        return 2;
+    }
+
+    TSharedRef<FJsonObject> Config = MakeShared<FJsonObject>();
+    Config->SetArrayField(TEXT("extra_bones"), ToJsonArray(ExtraBones));
+    Config->SetArrayField(TEXT("scales"), ToJsonArray(Scales));
+    Config->SetArrayField(TEXT("limb_scales"), ToJsonArray(LimbScales));
+    Config->SetArrayField(TEXT("frames"), ToJsonArray(ClipFrames));
+    Config->SetNumberField(TEXT("seed"), Seed);
+    Config->SetNumberField(TEXT("repeat"), Repeat);
+    Config->SetStringField(TEXT("options"), WorkerOptions.TrimStart());
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetNumberField(TEXT("version"), 1);
+    Report->SetStringField(TEXT("name"), BenchmarkName);
+    Report->SetObjectField(TEXT("config"), Config);
+    const TArray<FRetargetPair> InProcessPairs = MakePairs(FPaths::Combine(OutputDir, TEXT("Output")));
+    Report->SetObjectField(TEXT("inprocess"), RunInProcess(InProcessPairs));
+    // -validatecompress: retargets the pairs again with compression and compares the outputs with the -nocompress ones
+    if (FParse::Param(*Params, TEXT("validatecompress"))) {
+        if (bNoCompress && !FParse::Param(*Params, TEXT("directexport"))) {
+            Report->SetObjectField(TEXT("compression_check"),
+                CompareWithCompression(InProcessPairs, FPaths::Combine(OutputDir, TEXT("OutputCompressed"))));
+        } else {
+            UE_LOG(RetargetAllCommandlet, Warning,
+                TEXT("Benchmark: -validatecompress needs -nocompress without -directexport, ignoring it"));
+        }
+    }
+    if (NumWorkers > 0) {
+        const TArray<FRetargetPair> Pairs = MakePairs(FPaths::Combine(OutputDir, TEXT("OutputWorkers")));
+        if (TSharedPtr<FJsonObject> Workers = RunWorkerPool(Pairs)) {
+            Report->SetObjectField(TEXT("workers"), Workers);
+        }
+    }
+
+    FString Json;
+    FJsonSerializer::Serialize(Report, TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json));
+    const FString ReportFile = FPaths::Combine(OutputDir, TEXT("benchmark.json"));
+    FFileHelper::SaveStringToFile(Json, *ReportFile);
+    UE_LOG(RetargetAllCommandlet, Display, TEXT("Benchmark report %s: %s"), *ReportFile, *Json);
+    return 0;
+}
+
+bool URetargetBenchmarkCommandlet::GenerateInputs(const FString& InputDir)
+{
+    const FFrameRate FrameRate(30, 1);
+    FRandomStream Random(Seed);
+    TArray<FRawAnimSequenceTrack> Tracks;
+
+    const int32 NumVariants = FMath::Max3(ExtraBones.Num(), Scales.Num(), LimbScales.Num());
+    for (int32 Variant = 0; Variant < NumVariants; ++Variant) {
+        FReferenceSkeleton RefSkeleton;
+        MakeHumanoid(GetPadded(ExtraBones, Variant), GetPadded(Scales, Variant), GetPadded(LimbScales, Variant),
+            RefSkeleton);
+        MakeMotion(RefSkeleton, 1, FrameRate, Random, Tracks);
+        const FString File = FPaths::Combine(InputDir, FString::Printf(TEXT("Skeleton_%d.fbx"), Variant));
+        if (!RetargetFbx::WriteFbx(File, RefSkeleton, Tracks, FrameRate)) {
+            return false;
+        }
+        SkeletonFiles.Add(File);
+    }
+
+    // Animations play on the first variant
+    FReferenceSkeleton SourceSkeleton;
+    MakeHumanoid(ExtraBones[0], Scales[0], LimbScales[0], SourceSkeleton);
+    for (int32 NumFrames : ClipFrames) {
+        MakeMotion(SourceSkeleton, FMath::Max(2, NumFrames), FrameRate, Random, Tracks);
+        const FString File = FPaths::Combine(InputDir, FString::Printf(TEXT("Animation_%d.fbx"), NumFrames));
+        if (!RetargetFbx::WriteFbx(File, SourceSkeleton, Tracks, FrameRate)) {
+            return false;
+        }
+        AnimationFiles.Add(File);
+    }
+
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Benchmark: generated %d skeletons and %d animations in %s"),
+        SkeletonFiles.Num(), AnimationFiles.Num(), *InputDir);
+    return true;
+}
+
+TArray<FRetargetPair> URetargetBenchmarkCommandlet::MakePairs(const FString& OutputDir) const
+{
+    // Every animation on every skeleton, Repeat times
+    IFileManager::Get().MakeDirectory(*OutputDir, /*Tree*/ true);
+    TArray<FRetargetPair> Pairs;
+    for (int32 Round = 0; Round < Repeat; ++Round) {
+        for (const FString& AnimationFile : AnimationFiles) {
+            for (const FString& SkeletonFile : SkeletonFiles) {
+                FRetargetPair Pair;
+                Pair.JobIndex = Pairs.Num() / PairsPerJob;
+                Pair.AnimationFile = AnimationFile;
+                Pair.SkeletonFile = SkeletonFile;
+                Pair.OutputFile = FPaths::Combine(OutputDir,
+                    FString::Printf(TEXT("%s_%s_%d.fbx"), *FPaths::GetBaseFilename(AnimationFile),
+                        *FPaths::GetBaseFilename(SkeletonFile), Round));
+                Pairs.Add(MoveTemp(Pair));
+            }
+        }
+    }
+    return Pairs;
+}
+
+TSharedPtr<FJsonObject> URetargetBenchmarkCommandlet::RunInProcess(const TArray<FRetargetPair>& Pairs)
+{
+    TArray<FString> Animations, Targets, Outputs;
+    for (const FRetargetPair& Pair : Pairs) {
+        Animations.Add(Pair.AnimationFile);
+        Targets.Add(Pair.SkeletonFile);
+        Outputs.Add(Pair.OutputFile);
+    }
+
+    const FString Run = BenchmarkName + TEXT("_inprocess");
+    FRetargeterModule::Get().SetMetricsOutput(Run);
+
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Benchmark: retargeting %d pairs in process"), Pairs.Num());
+    const double StartTime = FPlatformTime::Seconds();
+    {
+        // Per-pair logging would dominate short clips
+        LOG_SCOPE_VERBOSITY_OVERRIDE(Retargeter, ELogVerbosity::Warning);
+        FRetargeterModule::Get().RetargetPairs(Animations, Targets, Outputs);
+    }
+    return SummarizeBenchmarkRun(Run, FPlatformTime::Seconds() - StartTime);
+}
+
+TSharedPtr<FJsonObject> URetargetBenchmarkCommandlet::CompareWithCompression(
+    const TArray<FRetargetPair>& Pairs, const FString& OutputDir)
+{
+    const TArray<FRetargetPair> CompressedPairs = MakePairs(OutputDir);
+    TArray<FString> Animations, Targets, Outputs;
+    for (const FRetargetPair& Pair : CompressedPairs) {
+        Animations.Add(Pair.AnimationFile);
+        Targets.Add(Pair.SkeletonFile);
+        Outputs.Add(Pair.OutputFile);
+    }
+
+    FRetargeterModule& Retargeter = FRetargeterModule::Get();
+    Retargeter.SetMetricsOutput(FString());
+    Retargeter.SetSkipCompression(false);
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Benchmark: retargeting %d pairs again with compression"), Pairs.Num());
+    {
+        LOG_SCOPE_VERBOSITY_OVERRIDE(Retargeter, ELogVerbosity::Warning);
+        Retargeter.RetargetPairs(Animations, Targets, Outputs);
+    }
+    Retargeter.SetSkipCompression(true);
+
+    float MaxError = 0.f;
+    int32 NumCompared = 0;
+    for (int32 Index = 0; Index < Pairs.Num(); ++Index) {
+        FRetargetFbxClip Uncompressed, Compressed;
+        if (!RetargetFbx::ReadFbx(Pairs[Index].OutputFile, true, Uncompressed)
+            || !RetargetFbx::ReadFbx(CompressedPairs[Index].OutputFile, true, Compressed)
+            || Uncompressed.LocalPoses.Num() != Compressed.LocalPoses.Num()) {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("Benchmark: cannot compare %s with %s"),
+                *Pairs[Index].OutputFile, *CompressedPairs[Index].OutputFile);
+            continue;
+        }
+        MaxError = FMath::Max(MaxError, MaxClipError(Uncompressed, Compressed));
+        NumCompared++;
+    }
+
+    const bool bMatch = NumCompared == Pairs.Num() && MaxError <= RetargetSimd::KeyTolerance;
+    if (bMatch) {
+        UE_LOG(RetargetAllCommandlet, Display,
+            TEXT("Benchmark: -nocompress outputs match compressed ones (max error %g)"), MaxError);
+    } else {
+        UE_LOG(RetargetAllCommandlet, Warning,
+            TEXT("Benchmark: -nocompress outputs differ from compressed ones (%d of %d compared, max error %g)"),
+            NumCompared, Pairs.Num(), MaxError);
+    }
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("pairs"), NumCompared);
+    Result->SetNumberField(TEXT("max_error"), MaxError);
+    Result->SetBoolField(TEXT("match"), bMatch);
+    return Result;
+}
+
+TSharedPtr<FJsonObject> URetargetBenchmarkCommandlet::RunWorkerPool(const TArray<FRetargetPair>& Pairs)
+{
+    const FString QueueDir = FPaths::ConvertRelativePathToFull(
+        FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved/Workers/"), BenchmarkName));
+    if (!FRetargetWorkQueue::Write(QueueDir, Pairs)) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Benchmark: failed to write work queue: %s"), *QueueDir);
+        return nullptr;
+    }
+
+    // Wall time includes worker startup, as in a real run
+    const FString Run = BenchmarkName + TEXT("_workers");
+    const FString EditorExe = FPlatformProcess::GetApplicationName(FPlatformProcess::GetCurrentProcessId());
+    const FString ProjectPath = FPaths::GetProjectFilePath();
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FProcHandle> WorkerProcesses;
+    for (int32 i = 0; i < NumWorkers; ++i) {
+        const FString Suffix = FString::Printf(TEXT("bench%d_%d"), i, FPlatformProcess::GetCurrentProcessId());
+        const FString UserDir = FPaths::ConvertRelativePathToFull(
+            FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved/Workers/"), Suffix));
+        IFileManager::Get().MakeDirectory(*UserDir, /*Tree*/ true);
+        const FString LogFile = FPaths::ConvertRelativePathToFull(FPaths::Combine(
+            FPaths::ProjectDir(), TEXT("Saved/Logs/"), FString::Printf(TEXT("benchmark_worker_%d.log"), i)));
+
+        const FString Args = FString::Printf(
+            TEXT("\"%s\" -run=RetargetWorker -queue=\"%s\" -workerindex=%d -numworkers=%d -metrics=%s ")
+                TEXT("-abslog=\"%s\" -UserDir=\"%s\" -retarget_session_suffix=\"%s\" ")
+                    TEXT("-LogCmds=\"global off, log RetargetAllCommandlet verbose\" -NoStdOut --stdout -NOCONSOLE "
+                         "-unattended%s"),
+            *ProjectPath, *QueueDir, i, NumWorkers, *Run, *LogFile, *UserDir, *Suffix, *WorkerOptions);
+
+        FProcHandle ProcHandle
+            = FPlatformProcess::CreateProc(*EditorExe, *Args, true, false, false, nullptr, 0, nullptr, nullptr);
+        if (ProcHandle.IsValid()) {
+            WorkerProcesses.Add(ProcHandle);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Error, TEXT("Benchmark: failed to launch worker process %d"), i);
+        }
+    }
+
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Benchmark: retargeting %d pairs on %d workers"), Pairs.Num(),
+        WorkerProcesses.Num());
+    for (FProcHandle& ProcHandle : WorkerProcesses) {
+        FPlatformProcess::WaitForProc(ProcHandle);
+        FPlatformProcess::CloseProc(ProcHandle);
+    }
+    FRetargetWorkQueue::Remove(QueueDir);
+
+    TSharedPtr<FJsonObject> Result = SummarizeBenchmarkRun(Run, FPlatformTime::Seconds() - StartTime);
+    Result->SetNumberField(TEXT("workers"), WorkerProcesses.Num());
+    return Result;
+}
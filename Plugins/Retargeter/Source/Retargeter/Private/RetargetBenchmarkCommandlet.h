@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RetargetWorkQueue.h"
+#include "RetargetBenchmarkCommandlet.generated.h"
+
+/**
+ * Commandlet that generates synthetic humanoid FBX files and measures retargeting throughput on them,
+ * in process and through a pool of worker processes
+ */
+UCLASS()
+class URetargetBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URetargetBenchmarkCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+
+private:
+	bool GenerateInputs(const FString& InputDir);
+	TArray<FRetargetPair> MakePairs(const FString& OutputDir) const;
+	TSharedPtr<class FJsonObject> RunInProcess(const TArray<FRetargetPair>& Pairs);
+	TSharedPtr<class FJsonObject> RunWorkerPool(const TArray<FRetargetPair>& Pairs);
+	// Retargets Pairs again with compression into OutputDir and compares the keys with the -nocompress outputs
+	TSharedPtr<class FJsonObject> CompareWithCompression(const TArray<FRetargetPair>& Pairs, const FString& OutputDir);
+
+	// Skeleton variants; shorter lists repeat their last value
+	TArray<int32> ExtraBones;
+	TArray<float> Scales;
+	TArray<float> LimbScales;
+	// One source animation per clip length
+	TArray<int32> ClipFrames;
+	int32 Seed = 42;
+	int32 Repeat = 1;
+	int32 NumWorkers = 0;
+	int32 PairsPerJob = 4;
+
+	FString BenchmarkName;
+	FString WorkerOptions;
+	TArray<FString> AnimationFiles;
+	TArray<FString> SkeletonFiles;
+};
@@ -1,4 +1,36 @@
 #include "RetargetCommandletShared.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
 
 // Define the shared log category for all retarget commandlets
 DEFINE_LOG_CATEGORY(RetargetAllCommandlet);
+
+TArray<FString> RetargetCommandlet::GetFBXFiles(const FString& DirectoryPath)
+{
+    TArray<FString> FbxFiles;
+    IFileManager::Get().FindFiles(FbxFiles, *FPaths::Combine(DirectoryPath, TEXT("*.fbx")), true, false);
+    for (FString& File : FbxFiles) {
+        File = FPaths::Combine(DirectoryPath, File);
+    }
+
+    // Sort files to ensure consistent ordering across runs
+    FbxFiles.Sort();
+
+    return FbxFiles;
+}
+
+TArray<FString> RetargetCommandlet::GetRandomSubset(const TArray<FString>& InputArray, int32 Count, int32 Seed)
+{
+    TArray<FString> Result = InputArray;
+    if (Count < InputArray.Num()) {
+        // Perform Fisher-Yates shuffle with seeded random
+        FRandomStream RandomStream(Seed);
+        for (int32 i = Result.Num() - 1; i > 0; --i) {
+            const int32 j = RandomStream.RandRange(0, i);
+            Result.Swap(i, j);
+        }
+        Result.SetNum(Count);
+    }
+    return Result;
+}
@@ -0,0 +1,415 @@
+#include "RetargetFbx.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Engine/SkeletalMesh.h"
+#include "Misc/ScopeExit.h"
+#include "RetargeterLog.h"
+#include "RetargetKeyReduction.h"
+
+THIRD_PARTY_INCLUDES_START
+#include <fbxsdk.h>
+THIRD_PARTY_INCLUDES_END
+
+namespace {
+// Same conventions as the editor FBX importer: Z up, -Y forward, right handed, centimeters,
+// then Y mirrored into Unreal's left-handed space
+const FbxAxisSystem& GetUnrealFbxAxis()
+{
+    static const FbxAxisSystem Axis(
+        FbxAxisSystem::eZAxis, (FbxAxisSystem::EFrontVector)-FbxAxisSystem::eParityOdd, FbxAxisSystem::eRightHanded);
+    return Axis;
+}
+
+FTransform ToUnreal(const FbxAMatrix& Matrix)
+{
+    const FbxVector4 T = Matrix.GetT();
+    const FbxQuaternion Q = Matrix.GetQ();
+    const FbxVector4 S = Matrix.GetS();
+    FTransform Result;
+    Result.SetTranslation(FVector(T[0], -T[1], T[2]));
+    Result.SetRotation(FQuat(Q[0], -Q[1], Q[2], -Q[3]).GetNormalized());
+    Result.SetScale3D(FVector(S[0], S[1], S[2]));
+    return Result;
+}
+
+FbxDouble3 ToFbxTranslation(const FVector3f& T) { return FbxDouble3(T.X, -T.Y, T.Z); }
+
+// FBX nodes take XYZ Euler angles in degrees
+FbxDouble3 ToFbxEuler(const FQuat4f& Q)
+{
+    FbxAMatrix Matrix;
+    Matrix.SetQ(FbxQuaternion(Q.X, -Q.Y, Q.Z, -Q.W));
+    const FbxVector4 Euler = Matrix.GetR();
+    return FbxDouble3(Euler[0], Euler[1], Euler[2]);
+}
+
+FbxDouble3 ToFbxScale(const FVector3f& S) { return FbxDouble3(S.X, S.Y, S.Z); }
+
+// Tolerance < 0 keeps every key. Returns the number of keys left on the three curves.
+int32 AddKeys(FbxPropertyT<FbxDouble3>& Property, FbxAnimLayer* Layer, const TArray<FbxTime>& Times,
+    TFunctionRef<FbxDouble3(int32)> GetValue, bool bUnroll, float Tolerance)
+{
+    const char* Components[3] = { FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y,
+        FBXSDK_CURVENODE_COMPONENT_Z };
+    FbxAnimCurve* Curves[3];
+    for (int32 Axis = 0; Axis < 3; ++Axis) {
+        Curves[Axis] = Property.GetCurve(Layer, Components[Axis], true);
+        Curves[Axis]->KeyModifyBegin();
+    }
+    for (int32 Frame = 0; Frame < Times.Num(); ++Frame) {
+        const FbxDouble3 Value = GetValue(Frame);
+        for (int32 Axis = 0; Axis < 3; ++Axis) {
+            const int KeyIndex = Curves[Axis]->KeyAdd(Times[Frame]);
+            Curves[Axis]->KeySet(KeyIndex, Times[Frame], float(Value[Axis]), FbxAnimCurveDef::eInterpolationLinear);
+        }
+    }
+    for (int32 Axis = 0; Axis < 3; ++Axis) {
+        Curves[Axis]->KeyModifyEnd();
+    }
+    if (bUnroll) {
+        // Avoid +-180 degree flips between consecutive Euler keys
+        FbxAnimCurveFilterUnroll Unroll;
+        Unroll.Apply(Curves, 3);
+    }
+    if (Tolerance < 0.f) {
+        return 3 * Times.Num();
+    }
+
+    // Reduce the final (unrolled) curves, so the bound holds for what FBX interpolates
+    int32 NumKept = 0;
+    TArray<float> Values;
+    TArray<int32> KeptFrames;
+    for (int32 Axis = 0; Axis < 3; ++Axis) {
+        Values.SetNum(Times.Num());
+        for (int32 Frame = 0; Frame < Times.Num(); ++Frame) {
+            Values[Frame] = Curves[Axis]->KeyGetValue(Frame);
+        }
+        RetargetKeyReduction::ReduceCurve(Values, Tolerance, KeptFrames);
+        NumKept += KeptFrames.Num();
+
+        Curves[Axis]->KeyModifyBegin();
+        Curves[Axis]->KeyClear();
+        for (const int32 Frame : KeptFrames) {
+            const int KeyIndex = Curves[Axis]->KeyAdd(Times[Frame]);
+            Curves[Axis]->KeySet(KeyIndex, Times[Frame], Values[Frame], FbxAnimCurveDef::eInterpolationLinear);
+        }
+        Curves[Axis]->KeyModifyEnd();
+    }
+    return NumKept;
+}
+
+// Strips namespaces ("mixamorig:Hips") and characters not allowed in bone names
+FName MakeBoneName(const char* FbxName)
+{
+    FString Name = UTF8_TO_TCHAR(FbxName);
+    int32 NamespaceIndex = INDEX_NONE;
+    if (Name.FindLastChar(TEXT(':'), NamespaceIndex)) {
+        Name.RightChopInline(NamespaceIndex + 1);
+    }
+    for (TCHAR& Char : Name) {
+        if (Char == TEXT(' ') || Char == TEXT('.') || Char == TEXT(',') || Char == TEXT('/') || Char == TEXT('`')
+            || Char == TEXT('%')) {
+            Char = TEXT('_');
+        }
+    }
+    return FName(*Name);
+}
+
+bool IsSkeletonNode(FbxNode* Node)
+{
+    const FbxNodeAttribute* Attribute = Node->GetNodeAttribute();
+    return Attribute && Attribute->GetAttributeType() == FbxNodeAttribute::eSkeleton;
+}
+
+// Depth-first so parents always come before their children
+void CollectBones(FbxNode* Node, int32 ParentIndex, TArray<FbxNode*>& OutNodes, TArray<int32>& OutParents)
+{
+    const int32 Index = OutNodes.Add(Node);
+    OutParents.Add(ParentIndex);
+    for (int32 ChildIndex = 0; ChildIndex < Node->GetChildCount(); ++ChildIndex) {
+        FbxNode* Child = Node->GetChild(ChildIndex);
+        if (IsSkeletonNode(Child)) {
+            CollectBones(Child, Index, OutNodes, OutParents);
+        }
+    }
+}
+
+FbxNode* FindSkeletonRoot(FbxNode* Node)
+{
+    if (IsSkeletonNode(Node)) {
+        return Node;
+    }
+    for (int32 ChildIndex = 0; ChildIndex < Node->GetChildCount(); ++ChildIndex) {
+        if (FbxNode* Root = FindSkeletonRoot(Node->GetChild(ChildIndex))) {
+            return Root;
+        }
+    }
+    return nullptr;
+}
+
+void SampleLocalPose(const TArray<FbxNode*>& Nodes, const TArray<int32>& Parents, const FbxTime& Time,
+    TArray<FTransform>& Globals, FTransform* OutLocal)
+{
+    for (int32 BoneIndex = 0; BoneIndex < Nodes.Num(); ++BoneIndex) {
+        Globals[BoneIndex] = ToUnreal(Nodes[BoneIndex]->EvaluateGlobalTransform(Time));
+        OutLocal[BoneIndex] = Parents[BoneIndex] == INDEX_NONE
+            ? Globals[BoneIndex]
+            : Globals[BoneIndex].GetRelativeTransform(Globals[Parents[BoneIndex]]);
+    }
+}
+
+FbxPose* FindBindPose(FbxScene* Scene)
+{
+    for (int32 PoseIndex = 0; PoseIndex < Scene->GetPoseCount(); ++PoseIndex) {
+        if (Scene->GetPose(PoseIndex)->IsBindPose()) {
+            return Scene->GetPose(PoseIndex);
+        }
+    }
+    return nullptr;
+}
+
+// Reference pose from the bind pose, as the editor importer uses. Bones the bind pose does not list, and every
+// bone of a scene without one, take their default node values below their parent.
+void SampleRefPose(const TArray<FbxNode*>& Nodes, const TArray<int32>& Parents, FbxPose* BindPose,
+    TArray<FTransform>& Globals, FTransform* OutLocal)
+{
+    TArray<FbxAMatrix> FbxGlobals;
+    FbxGlobals.SetNum(Nodes.Num());
+    for (int32 BoneIndex = 0; BoneIndex < Nodes.Num(); ++BoneIndex) {
+        FbxNode* Node = Nodes[BoneIndex];
+        const int32 PoseIndex = BindPose ? BindPose->Find(Node) : -1;
+        if (PoseIndex >= 0) {
+            // Bind pose matrices are global and affine, stored as a general matrix
+            FbxMatrix Matrix = BindPose->GetMatrix(PoseIndex);
+            FbxGlobals[BoneIndex] = *reinterpret_cast<FbxAMatrix*>(static_cast<double*>(Matrix));
+        } else if (Parents[BoneIndex] != INDEX_NONE) {
+            FbxGlobals[BoneIndex]
+                = FbxGlobals[Parents[BoneIndex]] * Node->EvaluateLocalTransform(FBXSDK_TIME_INFINITE);
+        } else {
+            FbxGlobals[BoneIndex] = Node->EvaluateGlobalTransform(FBXSDK_TIME_INFINITE);
+        }
+        Globals[BoneIndex] = ToUnreal(FbxGlobals[BoneIndex]);
+        OutLocal[BoneIndex] = Parents[BoneIndex] == INDEX_NONE
+            ? Globals[BoneIndex]
+            : Globals[BoneIndex].GetRelativeTransform(Globals[Parents[BoneIndex]]);
+    }
+}
+
+// Exact rate of the scene's time mode, e.g. 30000/1001 for NTSC and the stored rate for custom modes
+FFrameRate GetSceneFrameRate(FbxScene* Scene)
+{
+    const FbxGlobalSettings& Settings = Scene->GetGlobalSettings();
+    const FbxTime::EMode TimeMode = Settings.GetTimeMode();
+    const double Rate
+        = TimeMode == FbxTime::eCustom ? Settings.GetCustomFrameRate() : FbxTime::GetFrameRate(TimeMode);
+    if (!(Rate > 0.0)) {
+        return FFrameRate(30, 1);
+    }
+    if (FMath::IsNearlyEqual(Rate, FMath::RoundToDouble(Rate), 1e-4)) {
+        return FFrameRate(FMath::RoundToInt(Rate), 1);
+    }
+    const double NtscRate = Rate * 1.001;
+    if (FMath::IsNearlyEqual(NtscRate, FMath::RoundToDouble(NtscRate), 1e-3)) {
+        return FFrameRate(FMath::RoundToInt(NtscRate) * 1000, 1001);
+    }
+    return FFrameRate(FMath::RoundToInt(Rate * 1000.0), 1000);
+}
+} // namespace
+
+bool RetargetFbx::ReadFbx(const FString& FbxPath, bool bReadAnimation, FRetargetFbxClip& OutClip)
+{
+    FbxManager* Manager = FbxManager::Create();
+    ON_SCOPE_EXIT { Manager->Destroy(); };
+    Manager->SetIOSettings(FbxIOSettings::Create(Manager, IOSROOT));
+
+    FbxImporter* Importer = FbxImporter::Create(Manager, "");
+    if (!Importer->Initialize(TCHAR_TO_UTF8(*FbxPath), -1, Manager->GetIOSettings())) {
+        UE_LOG(Retargeter, Error, TEXT("ReadFbx: cannot open %s: %s"), *FbxPath,
+            UTF8_TO_TCHAR(Importer->GetStatus().GetErrorString()));
+        return false;
+    }
+    FbxScene* Scene = FbxScene::Create(Manager, "");
+    const bool bImported = Importer->Import(Scene);
+    Importer->Destroy();
+    if (!bImported) {
+        UE_LOG(Retargeter, Error, TEXT("ReadFbx: failed to parse %s"), *FbxPath);
+        return false;
+    }
+
+    const FbxAxisSystem& UnrealAxis = GetUnrealFbxAxis();
+    if (Scene->GetGlobalSettings().GetAxisSystem() != UnrealAxis) {
+        FbxRootNodeUtility::RemoveAllFbxRoots(Scene);
+        UnrealAxis.ConvertScene(Scene);
+    }
+    if (Scene->GetGlobalSettings().GetSystemUnit() != FbxSystemUnit::cm) {
+        FbxSystemUnit::cm.ConvertScene(Scene);
+    }
+
+    FbxNode* Root = FindSkeletonRoot(Scene->GetRootNode());
+    if (!Root) {
+        UE_LOG(Retargeter, Error, TEXT("ReadFbx: no skeleton in %s"), *FbxPath);
+        return false;
+    }
+    TArray<FbxNode*> Nodes;
+    TArray<int32> Parents;
+    CollectBones(Root, INDEX_NONE, Nodes, Parents);
+
+    TArray<FTransform> Globals;
+    Globals.SetNum(Nodes.Num());
+    TArray<FTransform> RefPose;
+    RefPose.SetNum(Nodes.Num());
+    SampleRefPose(Nodes, Parents, FindBindPose(Scene), Globals, RefPose.GetData());
+
+    OutClip.RefSkeleton.Empty(Nodes.Num());
+    {
+        FReferenceSkeletonModifier Modifier(OutClip.RefSkeleton, nullptr);
+        for (int32 BoneIndex = 0; BoneIndex < Nodes.Num(); ++BoneIndex) {
+            const FName BoneName = MakeBoneName(Nodes[BoneIndex]->GetName());
+            if (OutClip.RefSkeleton.FindRawBoneIndex(BoneName) != INDEX_NONE) {
+                UE_LOG(Retargeter, Error, TEXT("ReadFbx: duplicate bone %s in %s"), *BoneName.ToString(), *FbxPath);
+                return false;
+            }
+            Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), Parents[BoneIndex]), RefPose[BoneIndex]);
+        }
+    }
+
+    OutClip.NumFrames = 0;
+    OutClip.LocalPoses.Reset();
+    if (!bReadAnimation) {
+        return true;
+    }
+
+    FbxAnimStack* AnimStack = Scene->GetSrcObject<FbxAnimStack>(0);
+    if (!AnimStack) {
+        UE_LOG(Retargeter, Error, TEXT("ReadFbx: no animation in %s"), *FbxPath);
+        return false;
+    }
+    Scene->SetCurrentAnimationStack(AnimStack);
+
+    const FbxTimeSpan Span = AnimStack->GetLocalTimeSpan();
+    OutClip.FrameRate = GetSceneFrameRate(Scene);
+    OutClip.NumFrames
+        = FMath::Max(1, FMath::RoundToInt(Span.GetDuration().GetSecondDouble() * OutClip.FrameRate.AsDecimal()));
+    OutClip.LocalPoses.SetNum(OutClip.NumFrames * Nodes.Num());
+
+    for (int32 FrameIndex = 0; FrameIndex < OutClip.NumFrames; ++FrameIndex) {
+        FbxTime Time;
+        Time.SetSecondDouble(Span.GetStart().GetSecondDouble() + OutClip.FrameRate.AsSeconds(FFrameTime(FrameIndex)));
+        SampleLocalPose(Nodes, Parents, Time, Globals, &OutClip.LocalPoses[FrameIndex * Nodes.Num()]);
+    }
+    return true;
+}
+
+USkeletalMesh* RetargetFbx::CreateTransientMesh(const FReferenceSkeleton& RefSkeleton, const FString& BaseName)
+{
+    USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage(),
+        MakeUniqueObjectName(GetTransientPackage(), USkeleton::StaticClass(), *(BaseName + TEXT("_Skeleton"))),
+        RF_Transient);
+    USkeletalMesh* Mesh = NewObject<USkeletalMesh>(GetTransientPackage(),
+        MakeUniqueObjectName(GetTransientPackage(), USkeletalMesh::StaticClass(), *BaseName), RF_Transient);
+
+    Mesh->SetRefSkeleton(RefSkeleton);
+    Mesh->CalculateInvRefMatrices();
+    Skeleton->MergeAllBonesToBoneTree(Mesh);
+    Mesh->SetSkeleton(Skeleton);
+    return Mesh;
+}
+
+bool RetargetFbx::WriteFbx(const FString& FbxPath, const FReferenceSkeleton& RefSkeleton,
+    const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate,
+    const FRetargetKeyReductionSettings* Reduction, double* OutKeyRatio)
+{
+    const int32 NumBones = RefSkeleton.GetRawBoneNum();
+    if (BoneTracks.Num() != NumBones || NumBones == 0) {
+        UE_LOG(Retargeter, Error, TEXT("WriteFbx: %d tracks for %d bones"), BoneTracks.Num(), NumBones);
+        return false;
+    }
+
+    FbxManager* Manager = FbxManager::Create();
+    ON_SCOPE_EXIT { Manager->Destroy(); };
+    Manager->SetIOSettings(FbxIOSettings::Create(Manager, IOSROOT));
+
+    FbxScene* Scene = FbxScene::Create(Manager, "");
+    Scene->GetGlobalSettings().SetAxisSystem(GetUnrealFbxAxis());
+    Scene->GetGlobalSettings().SetSystemUnit(FbxSystemUnit::cm);
+    const FbxTime::EMode TimeMode = FbxTime::ConvertFrameRateToTimeMode(FrameRate.AsDecimal());
+    if (TimeMode == FbxTime::eDefaultMode) {
+        Scene->GetGlobalSettings().SetTimeMode(FbxTime::eCustom);
+        Scene->GetGlobalSettings().SetCustomFrameRate(FrameRate.AsDecimal());
+    } else {
+        Scene->GetGlobalSettings().SetTimeMode(TimeMode);
+    }
+
+    // Hierarchy in reference pose; parents precede children in the reference skeleton
+    const TArray<FMeshBoneInfo>& BoneInfos = RefSkeleton.GetRawRefBoneInfo();
+    const TArray<FTransform>& RefPose = RefSkeleton.GetRawRefBonePose();
+    TArray<FbxNode*> Nodes;
+    Nodes.SetNum(NumBones);
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        const FTCHARToUTF8 Name(*BoneInfos[BoneIndex].Name.ToString());
+        const int32 ParentIndex = BoneInfos[BoneIndex].ParentIndex;
+
+        FbxSkeleton* Attribute = FbxSkeleton::Create(Scene, Name.Get());
+        Attribute->SetSkeletonType(ParentIndex == INDEX_NONE ? FbxSkeleton::eRoot : FbxSkeleton::eLimbNode);
+        FbxNode* Node = FbxNode::Create(Scene, Name.Get());
+        Node->SetNodeAttribute(Attribute);
+
+        const FTransform& Ref = RefPose[BoneIndex];
+        Node->LclTranslation.Set(ToFbxTranslation(FVector3f(Ref.GetTranslation())));
+        Node->LclRotation.Set(ToFbxEuler(FQuat4f(Ref.GetRotation())));
+        Node->LclScaling.Set(ToFbxScale(FVector3f(Ref.GetScale3D())));
+
+        FbxNode* Parent = ParentIndex == INDEX_NONE ? Scene->GetRootNode() : Nodes[ParentIndex];
+        Parent->AddChild(Node);
+        Nodes[BoneIndex] = Node;
+    }
+
+    const int32 NumFrames = BoneTracks[0].PosKeys.Num();
+    TArray<FbxTime> Times;
+    Times.SetNum(NumFrames);
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame) {
+        Times[Frame].SetSecondDouble(FrameRate.AsSeconds(FFrameTime(Frame)));
+    }
+
+    FbxAnimStack* AnimStack = FbxAnimStack::Create(Scene, "Take 001");
+    FbxAnimLayer* Layer = FbxAnimLayer::Create(Scene, "BaseLayer");
+    AnimStack->AddMember(Layer);
+    AnimStack->SetLocalTimeSpan(FbxTimeSpan(FBXSDK_TIME_ZERO, Times.Num() > 0 ? Times.Last() : FBXSDK_TIME_ZERO));
+
+    const float TranslationTolerance = Reduction ? Reduction->TranslationTolerance : -1.f;
+    const float RotationTolerance = Reduction ? Reduction->RotationTolerance : -1.f;
+    const float ScaleTolerance = Reduction ? Reduction->ScaleTolerance : -1.f;
+    int64 NumKept = 0;
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        const FRawAnimSequenceTrack& Track = BoneTracks[BoneIndex];
+        FbxNode* Node = Nodes[BoneIndex];
+        NumKept += AddKeys(Node->LclTranslation, Layer, Times,
+            [&Track](int32 Frame) { return ToFbxTranslation(Track.PosKeys[Frame]); }, false, TranslationTolerance);
+        NumKept += AddKeys(Node->LclRotation, Layer, Times,
+            [&Track](int32 Frame) { return ToFbxEuler(Track.RotKeys[Frame]); }, true, RotationTolerance);
+        NumKept += AddKeys(Node->LclScaling, Layer, Times,
+            [&Track](int32 Frame) { return ToFbxScale(Track.ScaleKeys[Frame]); }, false, ScaleTolerance);
+    }
+    if (Reduction) {
+        const int64 NumKeys = int64(NumBones) * 9 * NumFrames;
+        UE_LOG(Retargeter, Log, TEXT("WriteFbx: kept %lld of %lld keys (%.2fx smaller) in %s"), NumKept, NumKeys,
+            NumKept > 0 ? double(NumKeys) / double(NumKept) : 0.0, *FbxPath);
+        if (OutKeyRatio) {
+            *OutKeyRatio = NumKeys > 0 ? double(NumKept) / double(NumKeys) : 0.0;
+        }
+    }
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FbxPath), /*Tree*/ true);
+    FbxExporter* Exporter = FbxExporter::Create(Manager, "");
+    const int32 BinaryFormat = Manager->GetIOPluginRegistry()->GetNativeWriterFormat();
+    const bool bOk = Exporter->Initialize(TCHAR_TO_UTF8(*FbxPath), BinaryFormat, Manager->GetIOSettings())
+        && Exporter->Export(Scene);
+    if (!bOk) {
+        UE_LOG(Retargeter, Error, TEXT("WriteFbx: failed to write %s: %s"), *FbxPath,
+            UTF8_TO_TCHAR(Exporter->GetStatus().GetErrorString()));
+    }
+    Exporter->Destroy();
+    return bOk;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+#include "ReferenceSkeleton.h"
+
+class USkeletalMesh;
+struct FRawAnimSequenceTrack;
+struct FRetargetKeyReductionSettings;
+
+// Skeleton and raw local bone transforms read straight from an FBX file, in Unreal space
+struct FRetargetFbxClip {
+    FReferenceSkeleton RefSkeleton;
+    FFrameRate FrameRate = FFrameRate(30, 1);
+    int32 NumFrames = 0;
+    // Frame-major: LocalPoses[Frame * NumBones + Bone]
+    TArray<FTransform> LocalPoses;
+
+    int32 NumBones() const { return RefSkeleton.GetRawBoneNum(); }
+    const FTransform* GetFrame(int32 FrameIndex) const { return &LocalPoses[FrameIndex * NumBones()]; }
+};
+
+namespace RetargetFbx {
+// Reads the first skeleton hierarchy of FbxPath and, if requested, samples its first animation stack
+bool ReadFbx(const FString& FbxPath, bool bReadAnimation, FRetargetFbxClip& OutClip);
+
+// Transient mesh with a reference skeleton only (no render data), enough for IK rigs and the retarget processor
+USkeletalMesh* CreateTransientMesh(const FReferenceSkeleton& RefSkeleton, const FString& BaseName);
+
+// Writes a binary FBX with the skeleton hierarchy and one key per frame from local-space tracks
+// indexed like the reference skeleton. With Reduction, each curve keeps only the keys needed to stay
+// within its tolerance, and the kept/total key ratio is logged and returned in OutKeyRatio.
+bool WriteFbx(const FString& FbxPath, const FReferenceSkeleton& RefSkeleton,
+    const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate,
+    const FRetargetKeyReductionSettings* Reduction = nullptr, double* OutKeyRatio = nullptr);
+} // namespace RetargetFbx
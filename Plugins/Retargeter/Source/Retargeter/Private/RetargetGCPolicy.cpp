@@ -0,0 +1,70 @@
+#include "RetargetGCPolicy.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "RetargeterLog.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace {
+int64 GetResidentBytes() { return int64(FPlatformMemory::GetStats().UsedPhysical); }
+
+int32 GetLiveObjects() { return GUObjectArray.GetObjectArrayNumMinusAvailable(); }
+} // namespace
+
+void FRetargetGCPolicy::SetThresholds(int32 InRssMB, int32 InObjects, int32 InEveryPairs)
+{
+    RssMB = FMath::Max(0, InRssMB);
+    Objects = FMath::Max(0, InObjects);
+    EveryPairs = FMath::Max(0, InEveryPairs);
+    UE_LOG(Retargeter, Log, TEXT("GC policy: rss=%d MB, objects=%d, every %d pairs"), RssMB, Objects, EveryPairs);
+}
+
+double FRetargetGCPolicy::OnPairFinished()
+{
+    Stats.NumPairs++;
+    PairsSinceCollect++;
+    const TCHAR* Reason = GetCollectReason();
+    return Reason ? Collect(Reason) : 0.0;
+}
+
+FRetargetGCStats FRetargetGCPolicy::ConsumeStats()
+{
+    const FRetargetGCStats Result = Stats;
+    Stats = FRetargetGCStats();
+    return Result;
+}
+
+const TCHAR* FRetargetGCPolicy::GetCollectReason() const
+{
+    if (EveryPairs > 0 && PairsSinceCollect >= EveryPairs) {
+        return TEXT("pairs");
+    }
+    if (Objects > 0 && GetLiveObjects() >= Objects) {
+        return TEXT("objects");
+    }
+    if (RssMB > 0 && GetResidentBytes() >= int64(RssMB) * 1024 * 1024) {
+        return TEXT("rss");
+    }
+    return nullptr;
+}
+
+double FRetargetGCPolicy::Collect(const TCHAR* Reason)
+{
+    const int64 BytesBefore = GetResidentBytes();
+    const int32 ObjectsBefore = GetLiveObjects();
+    const double StartTime = FPlatformTime::Seconds();
+    CollectGarbage(RF_NoFlags);
+    const double Seconds = FPlatformTime::Seconds() - StartTime;
+    const int64 Reclaimed = BytesBefore - GetResidentBytes();
+    const int32 ReclaimedObjects = ObjectsBefore - GetLiveObjects();
+
+    UE_LOG(Retargeter, Log, TEXT("GC (%s) after %d pairs: %.1f ms, reclaimed %.1f MB and %d objects"), Reason,
+        PairsSinceCollect, Seconds * 1000.0, Reclaimed / (1024.0 * 1024.0), ReclaimedObjects);
+
+    PairsSinceCollect = 0;
+    Stats.NumCollections++;
+    Stats.Seconds += Seconds;
+    Stats.ReclaimedBytes += Reclaimed;
+    Stats.ReclaimedObjects += ReclaimedObjects;
+    return Seconds;
+}
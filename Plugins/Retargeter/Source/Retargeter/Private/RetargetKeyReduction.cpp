@@ -0,0 +1,40 @@
+#include "RetargetKeyReduction.h"
+
+void RetargetKeyReduction::ReduceCurve(const TArray<float>& Values, float Tolerance, TArray<int32>& OutKeptFrames)
+{
+    OutKeptFrames.Reset();
+    if (Values.Num() == 0) {
+        return;
+    }
+    OutKeptFrames.Add(0);
+
+    const bool bConstant = !Values.ContainsByPredicate(
+        [&Values, Tolerance](float Value) { return FMath::Abs(Value - Values[0]) > Tolerance; });
+    if (bConstant) {
+        return;
+    }
+
+    // Greedy: extend the segment from the last kept key until a value in between no longer fits the line.
+    // Lo and Hi bound the slopes from Values[Start] that keep every frame since Start within Tolerance, so
+    // each candidate end is checked in constant time.
+    int32 Start = 0;
+    float Lo = -MAX_flt;
+    float Hi = MAX_flt;
+    auto Narrow = [&Values, &Start, &Lo, &Hi, Tolerance](int32 Frame) {
+        const float Run = float(Frame - Start);
+        Lo = FMath::Max(Lo, (Values[Frame] - Tolerance - Values[Start]) / Run);
+        Hi = FMath::Min(Hi, (Values[Frame] + Tolerance - Values[Start]) / Run);
+    };
+    Narrow(1);
+    for (int32 End = 2; End < Values.Num(); ++End) {
+        const float Slope = (Values[End] - Values[Start]) / float(End - Start);
+        if (Slope < Lo || Slope > Hi) {
+            Start = End - 1;
+            OutKeptFrames.Add(Start);
+            Lo = -MAX_flt;
+            Hi = MAX_flt;
+        }
+        Narrow(End);
+    }
+    OutKeptFrames.Add(Values.Num() - 1);
+}
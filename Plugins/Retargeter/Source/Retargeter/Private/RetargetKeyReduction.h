@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Per-channel error bounds for output key reduction
+struct FRetargetKeyReductionSettings {
+    float TranslationTolerance = 0.01f; // cm
+    float RotationTolerance = 0.01f; // degrees
+    float ScaleTolerance = 1e-4f;
+};
+
+namespace RetargetKeyReduction {
+// Frames of an evenly sampled, linearly interpolated curve to keep so that every dropped value stays within
+// Tolerance. A constant curve (identity scale included) keeps only its first frame.
+void ReduceCurve(const TArray<float>& Values, float Tolerance, TArray<int32>& OutKeptFrames);
+} // namespace RetargetKeyReduction
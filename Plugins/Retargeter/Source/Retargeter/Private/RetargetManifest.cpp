@@ -0,0 +1,111 @@
+#include "RetargetManifest.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "RetargetCommandletShared.h"
+
+namespace {
+const TCHAR* ManifestDirName = TEXT(".manifest");
+const TCHAR* MergedFileName = TEXT("manifest.tsv");
+
+FString GetManifestDir(const FString& RetargetDir) { return FPaths::Combine(RetargetDir, ManifestDirName); }
+} // namespace
+
+FString FRetargetManifest::MakePairKey(
+    const FString& AnimationHash, const FString& TargetHash, const FString& Fingerprint)
+{
+    const FString Combined = FString::Printf(TEXT("%s|%s|%s"), *AnimationHash, *TargetHash, *Fingerprint);
+    return FMD5::HashAnsiString(*Combined);
+}
+
+FString FRetargetManifest::HashFile(const FString& FilePath) { return LexToString(FMD5Hash::HashFile(*FilePath)); }
+
+void FRetargetManifest::Append(const FString& OutputFile, const FString& Key)
+{
+    const int64 Size = IFileManager::Get().FileSize(*OutputFile);
+    if (Key.IsEmpty() || Size <= 0) {
+        return;
+    }
+
+    const FString ShardFile = FPaths::Combine(GetManifestDir(FPaths::GetPath(OutputFile)),
+        FString::Printf(TEXT("worker_%d.tsv"), FPlatformProcess::GetCurrentProcessId()));
+    const FString Line = FString::Printf(TEXT("%s\t%s\t%lld\n"), *FPaths::GetCleanFilename(OutputFile), *Key, Size);
+    FFileHelper::SaveStringToFile(
+        Line, *ShardFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+void FRetargetManifest::Load(const FString& RetargetDir)
+{
+    Entries.Reset();
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *FPaths::Combine(GetManifestDir(RetargetDir), TEXT("*.tsv")), true, false);
+    // Merged file first so newer worker shards override it
+    Files.Sort([](const FString& A, const FString& B) { return A == MergedFileName && B != MergedFileName; });
+
+    for (const FString& File : Files) {
+        TArray<FString> Lines;
+        FFileHelper::LoadFileToStringArray(Lines, *FPaths::Combine(GetManifestDir(RetargetDir), File));
+        for (const FString& Line : Lines) {
+            TArray<FString> Fields;
+            Line.ParseIntoArray(Fields, TEXT("\t"), /*CullEmpty*/ false);
+            if (Fields.Num() != 3) {
+                continue;
+            }
+            FEntry& Entry = Entries.FindOrAdd(FPaths::Combine(RetargetDir, Fields[0]));
+            Entry.Key = Fields[1];
+            LexFromString(Entry.Size, *Fields[2]);
+        }
+    }
+    UE_LOG(RetargetAllCommandlet, Log, TEXT("Manifest: %d entries in %s"), Entries.Num(), *RetargetDir);
+}
+
+bool FRetargetManifest::IsUpToDate(const FString& OutputFile, const FString& Key) const
+{
+    const FEntry* Entry = Entries.Find(OutputFile);
+    return Entry && Entry->Key == Key && IFileManager::Get().FileSize(*OutputFile) == Entry->Size;
+}
+
+int32 FRetargetManifest::Prune(const FString& RetargetDir, const TSet<FString>& ScheduledNames)
+{
+    for (auto It = Entries.CreateIterator(); It; ++It) {
+        if (!ScheduledNames.Contains(FPaths::GetCleanFilename(It.Key()))) {
+            It.RemoveCurrent();
+        }
+    }
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *FPaths::Combine(RetargetDir, TEXT("*.fbx")), true, false);
+    int32 NumDeleted = 0;
+    for (const FString& File : Files) {
+        if (!ScheduledNames.Contains(File)
+            && IFileManager::Get().Delete(*FPaths::Combine(RetargetDir, File), false, /*EvenReadOnly*/ true)) {
+            ++NumDeleted;
+        }
+    }
+    return NumDeleted;
+}
+
+void FRetargetManifest::Compact(const FString& RetargetDir) const
+{
+    const FString ManifestDir = GetManifestDir(RetargetDir);
+
+    TArray<FString> Lines;
+    for (const TPair<FString, FEntry>& Pair : Entries) {
+        if (IFileManager::Get().FileSize(*Pair.Key) == Pair.Value.Size) {
+            Lines.Add(FString::Printf(
+                TEXT("%s\t%s\t%lld"), *FPaths::GetCleanFilename(Pair.Key), *Pair.Value.Key, Pair.Value.Size));
+        }
+    }
+
+    TArray<FString> Shards;
+    IFileManager::Get().FindFiles(Shards, *FPaths::Combine(ManifestDir, TEXT("worker_*.tsv")), true, false);
+    for (const FString& Shard : Shards) {
+        IFileManager::Get().Delete(*FPaths::Combine(ManifestDir, Shard));
+    }
+
+    IFileManager::Get().MakeDirectory(*ManifestDir, /*Tree*/ true);
+    FFileHelper::SaveStringArrayToFile(Lines, *FPaths::Combine(ManifestDir, MergedFileName));
+}
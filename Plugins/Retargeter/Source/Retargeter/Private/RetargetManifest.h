@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Record of finished outputs in a Retarget directory, used to skip unchanged pairs on re-runs.
+ * Workers append to per-process shard files under <Retarget>/.manifest; RetargetAll0 merges them.
+ */
+class FRetargetManifest {
+public:
+    // Key of a pair: input animation and target contents plus the settings that affect the output
+    static FString MakePairKey(const FString& AnimationHash, const FString& TargetHash, const FString& Fingerprint);
+    static FString HashFile(const FString& FilePath);
+
+    // Called by workers once OutputFile has been written
+    static void Append(const FString& OutputFile, const FString& Key);
+
+    void Load(const FString& RetargetDir);
+
+    // True when OutputFile was produced with Key and is still on disk with the recorded size
+    bool IsUpToDate(const FString& OutputFile, const FString& Key) const;
+
+    // Deletes FBX outputs in RetargetDir, and their entries, whose file name is not in ScheduledNames.
+    // Returns the number of files deleted.
+    int32 Prune(const FString& RetargetDir, const TSet<FString>& ScheduledNames);
+
+    // Rewrites the merged manifest with entries still on disk and removes the worker shards
+    void Compact(const FString& RetargetDir) const;
+
+private:
+    struct FEntry {
+        FString Key;
+        int64 Size = 0;
+    };
+    TMap<FString, FEntry> Entries;
+};
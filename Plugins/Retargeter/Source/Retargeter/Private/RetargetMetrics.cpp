@@ -0,0 +1,177 @@
+#include "RetargetMetrics.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace {
+FString GetMetricsDir() { return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Metrics")); }
+
+// Nearest-rank percentile of sorted values
+double Percentile(const TArray<double>& Sorted, double P)
+{
+    if (Sorted.Num() == 0) {
+        return 0.0;
+    }
+    const int32 Rank = FMath::CeilToInt(P * Sorted.Num()) - 1;
+    return Sorted[FMath::Clamp(Rank, 0, Sorted.Num() - 1)];
+}
+
+TSharedRef<FJsonObject> MakePercentiles(TArray<double>& Values)
+{
+    Values.Sort();
+    TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+    Object->SetNumberField(TEXT("p50"), Percentile(Values, 0.50));
+    Object->SetNumberField(TEXT("p90"), Percentile(Values, 0.90));
+    Object->SetNumberField(TEXT("p99"), Percentile(Values, 0.99));
+    Object->SetNumberField(TEXT("max"), Values.Num() > 0 ? Values.Last() : 0.0);
+    return Object;
+}
+} // namespace
+
+FString FRetargetPairMetrics::ToJson() const
+{
+    TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+    Object->SetStringField(TEXT("input"), InputFbx);
+    Object->SetStringField(TEXT("target"), TargetFbx);
+    Object->SetStringField(TEXT("output"), OutputPath);
+    Object->SetNumberField(TEXT("frames"), NumFrames);
+    Object->SetNumberField(TEXT("bones"), NumBones);
+    Object->SetNumberField(TEXT("bytes_read"), double(BytesRead));
+    Object->SetNumberField(TEXT("bytes_written"), double(BytesWritten));
+    Object->SetNumberField(TEXT("key_ratio"), KeyRatio);
+    Object->SetNumberField(TEXT("peak_rss_bytes"), double(PeakRssBytes));
+    Object->SetNumberField(TEXT("total_ms"), TotalSeconds * 1000.0);
+    Object->SetNumberField(TEXT("frames_per_sec"), TotalSeconds > 0.0 ? NumFrames / TotalSeconds : 0.0);
+    TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+    for (int32 Stage = 0; Stage < int32(ERetargetStage::Num); ++Stage) {
+        Stages->SetNumberField(RetargetMetrics::GetStageName(ERetargetStage(Stage)), StageSeconds[Stage] * 1000.0);
+    }
+    Object->SetObjectField(TEXT("stages_ms"), Stages);
+
+    // Condensed so each pair stays on one line of the JSONL file
+    FString Json;
+    FJsonSerializer::Serialize(Object, TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json));
+    return Json;
+}
+
+FRetargetMetricsWriter::~FRetargetMetricsWriter()
+{
+    if (Archive) {
+        Archive->Close();
+    }
+}
+
+bool FRetargetMetricsWriter::Open(const FString& FilePath)
+{
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), /*Tree*/ true);
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_Append | FILEWRITE_AllowRead));
+    return Archive.IsValid();
+}
+
+void FRetargetMetricsWriter::Write(const FRetargetPairMetrics& Metrics)
+{
+    if (!Archive) {
+        return;
+    }
+    const FTCHARToUTF8 Line(*(Metrics.ToJson() + TEXT("\n")));
+    Archive->Serialize(const_cast<ANSICHAR*>(Line.Get()), Line.Length());
+    Archive->Flush();
+}
+
+const TCHAR* RetargetMetrics::GetStageName(ERetargetStage Stage)
+{
+    switch (Stage) {
+    case ERetargetStage::Load:
+        return TEXT("load");
+    case ERetargetStage::IkRig:
+        return TEXT("ikrig");
+    case ERetargetStage::RTG:
+        return TEXT("rtg");
+    case ERetargetStage::Retarget:
+        return TEXT("retarget");
+    case ERetargetStage::Commit:
+        return TEXT("commit");
+    case ERetargetStage::Finalize:
+        return TEXT("finalize");
+    case ERetargetStage::Export:
+        return TEXT("export");
+    case ERetargetStage::Cleanup:
+        return TEXT("cleanup");
+    case ERetargetStage::GC:
+        return TEXT("gc");
+    default:
+        return TEXT("unknown");
+    }
+}
+
+FString RetargetMetrics::GetMetricsFile(const FString& Run, const FString& Session)
+{
+    return FPaths::Combine(GetMetricsDir(), FString::Printf(TEXT("%s_%s.jsonl"), *Run, *Session));
+}
+
+FString RetargetMetrics::SummarizeRun(const FString& Run, double WallSeconds)
+{
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *FPaths::Combine(GetMetricsDir(), Run + TEXT("_*.jsonl")), true, false);
+
+    int32 NumPairs = 0;
+    int64 NumFrames = 0, BytesRead = 0, BytesWritten = 0, PeakRssBytes = 0;
+    TArray<double> TotalMs, FramesPerSec;
+    TArray<double> StageMs[int32(ERetargetStage::Num)];
+    for (const FString& File : Files) {
+        TArray<FString> Lines;
+        FFileHelper::LoadFileToStringArray(Lines, *FPaths::Combine(GetMetricsDir(), File));
+        for (const FString& Line : Lines) {
+            TSharedPtr<FJsonObject> Pair;
+            if (!FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(Line), Pair) || !Pair) {
+                continue;
+            }
+            NumPairs++;
+            NumFrames += int64(Pair->GetNumberField(TEXT("frames")));
+            BytesRead += int64(Pair->GetNumberField(TEXT("bytes_read")));
+            BytesWritten += int64(Pair->GetNumberField(TEXT("bytes_written")));
+            PeakRssBytes = FMath::Max(PeakRssBytes, int64(Pair->GetNumberField(TEXT("peak_rss_bytes"))));
+            TotalMs.Add(Pair->GetNumberField(TEXT("total_ms")));
+            FramesPerSec.Add(Pair->GetNumberField(TEXT("frames_per_sec")));
+            const TSharedPtr<FJsonObject>* Stages = nullptr;
+            if (Pair->TryGetObjectField(TEXT("stages_ms"), Stages)) {
+                for (int32 Stage = 0; Stage < int32(ERetargetStage::Num); ++Stage) {
+                    StageMs[Stage].Add((*Stages)->GetNumberField(GetStageName(ERetargetStage(Stage))));
+                }
+            }
+        }
+    }
+    if (NumPairs == 0) {
+        return FString();
+    }
+
+    TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+    Summary->SetStringField(TEXT("run"), Run);
+    Summary->SetNumberField(TEXT("files"), Files.Num());
+    Summary->SetNumberField(TEXT("pairs"), NumPairs);
+    Summary->SetNumberField(TEXT("frames"), double(NumFrames));
+    Summary->SetNumberField(TEXT("bytes_read"), double(BytesRead));
+    Summary->SetNumberField(TEXT("bytes_written"), double(BytesWritten));
+    Summary->SetNumberField(TEXT("peak_rss_bytes"), double(PeakRssBytes));
+    Summary->SetNumberField(TEXT("wall_sec"), WallSeconds);
+    Summary->SetNumberField(TEXT("pairs_per_sec"), WallSeconds > 0.0 ? NumPairs / WallSeconds : 0.0);
+    Summary->SetNumberField(TEXT("frames_per_sec"), WallSeconds > 0.0 ? NumFrames / WallSeconds : 0.0);
+    Summary->SetObjectField(TEXT("pair_total_ms"), MakePercentiles(TotalMs));
+    Summary->SetObjectField(TEXT("pair_frames_per_sec"), MakePercentiles(FramesPerSec));
+    TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+    for (int32 Stage = 0; Stage < int32(ERetargetStage::Num); ++Stage) {
+        Stages->SetObjectField(GetStageName(ERetargetStage(Stage)), MakePercentiles(StageMs[Stage]));
+    }
+    Summary->SetObjectField(TEXT("stages_ms"), Stages);
+
+    FString Json;
+    FJsonSerializer::Serialize(Summary, TJsonWriterFactory<>::Create(&Json));
+    FFileHelper::SaveStringToFile(Json, *FPaths::Combine(GetMetricsDir(), Run + TEXT(".summary.json")));
+    return Json;
+}
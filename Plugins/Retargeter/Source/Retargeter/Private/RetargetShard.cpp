@@ -0,0 +1,236 @@
+#include "RetargetShard.h"
+#include "Animation/AnimSequence.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Math/Float16.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "ReferenceSkeleton.h"
+#include "RetargeterLog.h"
+
+namespace {
+const char ShardMagic[8] = { 'R', 'T', 'S', 'H', 'A', 'R', 'D', '1' };
+constexpr uint32 ShardVersion = 2;
+constexpr int64 ShardAlignment = 16;
+
+template <typename T> void AppendBytes(TArray<uint8>& Out, const T& Value)
+{
+    Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+} // namespace
+
+FRetargetShardWriter::~FRetargetShardWriter() { Close(); }
+
+int32 FRetargetShardWriter::GetRecordSize(ERetargetShardEncoding InEncoding)
+{
+    const int32 RotationSize = InEncoding == ERetargetShardEncoding::Float32 ? 16 : 8;
+    return 2 * 3 * sizeof(float) + RotationSize;
+}
+
+bool FRetargetShardWriter::Open(const FString& InPath, ERetargetShardEncoding InEncoding)
+{
+    Path = InPath;
+    PartialPath = Path + TEXT(".partial");
+    Encoding = InEncoding;
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), /*Tree*/ true);
+    Ar.Reset(IFileManager::Get().CreateFileWriter(*PartialPath));
+    if (!Ar) {
+        UE_LOG(Retargeter, Error, TEXT("Shard: cannot create %s"), *PartialPath);
+        return false;
+    }
+
+    // Placeholder header, rewritten on Close
+    FRetargetShardHeader Header = {};
+    Ar->Serialize(&Header, sizeof(Header));
+    Pad();
+    return true;
+}
+
+int64 FRetargetShardWriter::GetSize() const { return Ar ? Ar->Tell() : 0; }
+
+void FRetargetShardWriter::Pad()
+{
+    static const uint8 Zeros[ShardAlignment] = {};
+    const int64 Remainder = Ar->Tell() % ShardAlignment;
+    if (Remainder != 0) {
+        Ar->Serialize(const_cast<uint8*>(Zeros), ShardAlignment - Remainder);
+    }
+}
+
+uint32 FRetargetShardWriter::AddString(const FString& String, uint32& OutLength)
+{
+    const FTCHARToUTF8 Utf8(*String);
+    const uint32 Offset = Strings.Num();
+    OutLength = Utf8.Length();
+    Strings.Append(reinterpret_cast<const uint8*>(Utf8.Get()), OutLength);
+    return Offset;
+}
+
+bool FRetargetShardWriter::AddClip(const FString& SkeletonName, const FReferenceSkeleton& RefSkeleton,
+    const FString& AnimationName, const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate)
+{
+    const int32 NumBones = RefSkeleton.GetRawBoneNum();
+    if (!Ar || BoneTracks.Num() != NumBones || NumBones == 0) {
+        return false;
+    }
+
+    uint32* SkeletonIndex = SkeletonIndices.Find(SkeletonName);
+    if (!SkeletonIndex) {
+        FRetargetShardSkeleton& Skeleton = Skeletons.AddZeroed_GetRef();
+        Skeleton.NameOffset = AddString(SkeletonName, Skeleton.NameLength);
+        Skeleton.FirstBone = Bones.Num();
+        Skeleton.NumBones = NumBones;
+        for (const FMeshBoneInfo& Info : RefSkeleton.GetRawRefBoneInfo()) {
+            FRetargetShardBone& Bone = Bones.AddZeroed_GetRef();
+            Bone.NameOffset = AddString(Info.Name.ToString(), Bone.NameLength);
+            Bone.ParentIndex = Info.ParentIndex;
+        }
+        SkeletonIndex = &SkeletonIndices.Add(SkeletonName, Skeletons.Num() - 1);
+    }
+
+    const int32 NumFrames = BoneTracks[0].PosKeys.Num();
+    FRetargetShardClip& Clip = Clips.AddZeroed_GetRef();
+    Clip.SkeletonIndex = *SkeletonIndex;
+    Clip.AnimationNameOffset = AddString(AnimationName, Clip.AnimationNameLength);
+    Clip.NumFrames = NumFrames;
+    Clip.DataOffset = Ar->Tell();
+    Clip.FrameRate = float(FrameRate.AsDecimal());
+
+    // Frame-major records, one frame at a time
+    Scratch.Reset(NumBones * GetRecordSize(Encoding));
+    uint32 DataCrc = 0;
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame) {
+        Scratch.Reset();
+        for (const FRawAnimSequenceTrack& Track : BoneTracks) {
+            AppendBytes(Scratch, Track.PosKeys[Frame]);
+            AppendBytes(Scratch, Track.ScaleKeys[Frame]);
+
+            FQuat4f Rotation = Track.RotKeys[Frame];
+            if (Encoding == ERetargetShardEncoding::Float32) {
+                AppendBytes(Scratch, Rotation);
+                continue;
+            }
+            if (Rotation.W < 0.f) {
+                Rotation = FQuat4f(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+            }
+            const float Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+            for (const float Component : Components) {
+                if (Encoding == ERetargetShardEncoding::Float16) {
+                    AppendBytes(Scratch, FFloat16(Component).Encoded);
+                } else {
+                    AppendBytes(Scratch, int16(FMath::RoundToInt(FMath::Clamp(Component, -1.f, 1.f) * 32767.f)));
+                }
+            }
+        }
+        DataCrc = FCrc::MemCrc32(Scratch.GetData(), Scratch.Num(), DataCrc);
+        Ar->Serialize(Scratch.GetData(), Scratch.Num());
+    }
+    Clip.DataCrc = DataCrc;
+    Pad();
+    return !Ar->IsError();
+}
+
+bool FRetargetShardWriter::Close()
+{
+    if (!Ar) {
+        return false;
+    }
+
+    FRetargetShardHeader Header = {};
+    FMemory::Memcpy(Header.Magic, ShardMagic, sizeof(ShardMagic));
+    Header.Version = ShardVersion;
+    Header.Encoding = uint32(Encoding);
+    Header.RecordSize = GetRecordSize(Encoding);
+    Header.NumSkeletons = Skeletons.Num();
+    Header.NumBones = Bones.Num();
+    Header.NumClips = Clips.Num();
+
+    Header.SkeletonTableOffset = Ar->Tell();
+    Ar->Serialize(Skeletons.GetData(), Skeletons.Num() * sizeof(FRetargetShardSkeleton));
+    Pad();
+    Header.BoneTableOffset = Ar->Tell();
+    Ar->Serialize(Bones.GetData(), Bones.Num() * sizeof(FRetargetShardBone));
+    Pad();
+    Header.ClipIndexOffset = Ar->Tell();
+    Ar->Serialize(Clips.GetData(), Clips.Num() * sizeof(FRetargetShardClip));
+    Pad();
+    Header.StringsOffset = Ar->Tell();
+    Header.StringsSize = Strings.Num();
+    Ar->Serialize(Strings.GetData(), Strings.Num());
+    Pad();
+
+    Ar->Seek(0);
+    Ar->Serialize(&Header, sizeof(Header));
+    bool bOk = Ar->Close() && !Ar->IsError();
+    Ar.Reset();
+
+    // Only a complete shard takes the final name; a worker that dies first leaves just the .partial file
+    if (bOk) {
+        bOk = IFileManager::Get().Move(*Path, *PartialPath, /*Replace*/ true);
+    }
+
+    UE_LOG(Retargeter, Log, TEXT("Shard %s: %d clips, %d skeletons (%s)"), *Path, Clips.Num(), Skeletons.Num(),
+        bOk ? TEXT("ok") : TEXT("write error"));
+    return bOk;
+}
+
+FRetargetShardSink::FRetargetShardSink(ERetargetShardEncoding InEncoding, int64 InMaxShardBytes)
+    : Encoding(InEncoding)
+    , MaxShardBytes(InMaxShardBytes)
+{
+}
+
+FRetargetShardSink::~FRetargetShardSink() { Close(); }
+
+bool FRetargetShardSink::ParseEncoding(const FString& Name, ERetargetShardEncoding& OutEncoding)
+{
+    if (Name == TEXT("float32")) {
+        OutEncoding = ERetargetShardEncoding::Float32;
+    } else if (Name == TEXT("float16")) {
+        OutEncoding = ERetargetShardEncoding::Float16;
+    } else if (Name == TEXT("snorm16")) {
+        OutEncoding = ERetargetShardEncoding::Snorm16;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool FRetargetShardSink::AddClip(const FString& OutputPath, const FString& SkeletonName,
+    const FReferenceSkeleton& RefSkeleton, const FString& AnimationName,
+    const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate)
+{
+    const FString ShardDir = FPaths::Combine(FPaths::GetPath(OutputPath), TEXT("shards"));
+    TUniquePtr<FRetargetShardWriter>& Writer = Writers.FindOrAdd(ShardDir);
+    if (Writer && Writer->GetSize() >= MaxShardBytes) {
+        Writer->Close();
+        Writer.Reset();
+    }
+
+    if (!Writer) {
+        // Shards are per process, so workers never write to the same file
+        FString Path;
+        for (int32 Index = 0; Path.IsEmpty() || IFileManager::Get().FileExists(*Path)
+             || IFileManager::Get().FileExists(*(Path + TEXT(".partial")));
+             ++Index) {
+            Path = FPaths::Combine(ShardDir,
+                FString::Printf(TEXT("%d_%03d.rtshard"), FPlatformProcess::GetCurrentProcessId(), Index));
+        }
+        Writer = MakeUnique<FRetargetShardWriter>();
+        if (!Writer->Open(Path, Encoding)) {
+            Writer.Reset();
+            return false;
+        }
+    }
+    return Writer->AddClip(SkeletonName, RefSkeleton, AnimationName, BoneTracks, FrameRate);
+}
+
+void FRetargetShardSink::Close()
+{
+    for (TPair<FString, TUniquePtr<FRetargetShardWriter>>& Pair : Writers) {
+        if (Pair.Value) {
+            Pair.Value->Close();
+        }
+    }
+    Writers.Reset();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+
+class FArchive;
+struct FReferenceSkeleton;
+struct FRawAnimSequenceTrack;
+
+/**
+ * Binary shard of retargeted clips, laid out for mmap and zero-copy reads. All fields are little-endian
+ * and every section starts on a 16 byte boundary:
+ *   FRetargetShardHeader
+ *   clip data: per clip NumFrames x NumBones records, frame-major
+ *   skeleton table (FRetargetShardSkeleton[NumSkeletons]) and bone table (FRetargetShardBone[NumBones])
+ *   clip index (FRetargetShardClip[NumClips])
+ *   UTF-8 string blob referenced by offset/length pairs
+ * A record is translation float32x3, scale float32x3, then the rotation quaternion as float32x4,
+ * float16x4 or snorm16x4 (w >= 0), per header Encoding.
+ * Shards are written as <name>.partial and renamed once complete, so a shard on disk always has a valid header.
+ * Each clip index entry carries the CRC32 of its data.
+ */
+enum class ERetargetShardEncoding : uint32 {
+    Float32 = 0,
+    Float16 = 1,
+    Snorm16 = 2,
+};
+
+#pragma pack(push, 1)
+struct FRetargetShardHeader {
+    char Magic[8];
+    uint32 Version;
+    uint32 Encoding;
+    uint32 RecordSize;
+    uint32 NumSkeletons;
+    uint32 NumBones;
+    uint32 NumClips;
+    uint64 SkeletonTableOffset;
+    uint64 BoneTableOffset;
+    uint64 ClipIndexOffset;
+    uint64 StringsOffset;
+    uint64 StringsSize;
+};
+
+struct FRetargetShardSkeleton {
+    uint32 NameOffset;
+    uint32 NameLength;
+    uint32 FirstBone;
+    uint32 NumBones;
+};
+
+struct FRetargetShardBone {
+    uint32 NameOffset;
+    uint32 NameLength;
+    int32 ParentIndex;
+    uint32 Reserved;
+};
+
+struct FRetargetShardClip {
+    uint32 SkeletonIndex;
+    uint32 AnimationNameOffset;
+    uint32 AnimationNameLength;
+    uint32 NumFrames;
+    uint64 DataOffset;
+    float FrameRate;
+    uint32 DataCrc;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FRetargetShardHeader) == 72, "Shard header layout changed");
+static_assert(sizeof(FRetargetShardClip) == 32, "Shard clip layout changed");
+
+// Writes one shard file. Tables are written, the header patched and the file renamed into place on Close.
+class FRetargetShardWriter {
+public:
+    ~FRetargetShardWriter();
+
+    bool Open(const FString& InPath, ERetargetShardEncoding InEncoding);
+    bool AddClip(const FString& SkeletonName, const FReferenceSkeleton& RefSkeleton, const FString& AnimationName,
+        const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate);
+    bool Close();
+
+    int64 GetSize() const;
+    static int32 GetRecordSize(ERetargetShardEncoding Encoding);
+
+private:
+    uint32 AddString(const FString& String, uint32& OutLength);
+    void Pad();
+
+    FString Path;
+    FString PartialPath;
+    TUniquePtr<FArchive> Ar;
+    ERetargetShardEncoding Encoding = ERetargetShardEncoding::Float32;
+    TMap<FString, uint32> SkeletonIndices;
+    TArray<FRetargetShardSkeleton> Skeletons;
+    TArray<FRetargetShardBone> Bones;
+    TArray<FRetargetShardClip> Clips;
+    TArray<uint8> Strings;
+    TArray<uint8> Scratch;
+};
+
+// Routes clips to one shard per output directory and starts a new shard past MaxShardBytes
+class FRetargetShardSink {
+public:
+    FRetargetShardSink(ERetargetShardEncoding InEncoding, int64 InMaxShardBytes);
+    ~FRetargetShardSink();
+
+    bool AddClip(const FString& OutputPath, const FString& SkeletonName, const FReferenceSkeleton& RefSkeleton,
+        const FString& AnimationName, const TArray<FRawAnimSequenceTrack>& BoneTracks, const FFrameRate& FrameRate);
+    void Close();
+
+    static bool ParseEncoding(const FString& Name, ERetargetShardEncoding& OutEncoding);
+
+private:
+    ERetargetShardEncoding Encoding;
+    int64 MaxShardBytes;
+    TMap<FString, TUniquePtr<FRetargetShardWriter>> Writers;
+};
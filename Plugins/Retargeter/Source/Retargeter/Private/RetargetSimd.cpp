@@ -0,0 +1,245 @@
+#include "RetargetSimd.h"
+#include "Animation/AnimSequence.h"
+#include "Math/VectorRegister.h"
+
+namespace {
+struct FVec3 {
+    VectorRegister4Float X, Y, Z;
+};
+
+struct FQuat4 {
+    VectorRegister4Float X, Y, Z, W;
+};
+
+FORCEINLINE VectorRegister4Float Load(const TArray<float>& Array, int32 Index) { return VectorLoad(Array.GetData() + Index); }
+
+FORCEINLINE FVec3 Cross(const FVec3& A, const FVec3& B)
+{
+    return { VectorSubtract(VectorMultiply(A.Y, B.Z), VectorMultiply(A.Z, B.Y)),
+        VectorSubtract(VectorMultiply(A.Z, B.X), VectorMultiply(A.X, B.Z)),
+        VectorSubtract(VectorMultiply(A.X, B.Y), VectorMultiply(A.Y, B.X)) };
+}
+
+// Same as FQuat::operator* (A * B)
+FORCEINLINE FQuat4 Multiply(const FQuat4& A, const FQuat4& B)
+{
+    FQuat4 R;
+    R.W = VectorSubtract(VectorSubtract(VectorSubtract(VectorMultiply(A.W, B.W), VectorMultiply(A.X, B.X)),
+                             VectorMultiply(A.Y, B.Y)),
+        VectorMultiply(A.Z, B.Z));
+    R.X = VectorSubtract(VectorAdd(VectorAdd(VectorMultiply(A.W, B.X), VectorMultiply(A.X, B.W)), VectorMultiply(A.Y, B.Z)),
+        VectorMultiply(A.Z, B.Y));
+    R.Y = VectorAdd(VectorAdd(VectorSubtract(VectorMultiply(A.W, B.Y), VectorMultiply(A.X, B.Z)), VectorMultiply(A.Y, B.W)),
+        VectorMultiply(A.Z, B.X));
+    R.Z = VectorAdd(VectorSubtract(VectorAdd(VectorMultiply(A.W, B.Z), VectorMultiply(A.X, B.Y)), VectorMultiply(A.Y, B.X)),
+        VectorMultiply(A.Z, B.W));
+    return R;
+}
+
+// v' = v + w * t + q x t, with t = 2 * (q x v)
+FORCEINLINE FVec3 Rotate(const FQuat4& Q, const FVec3& V)
+{
+    const VectorRegister4Float Two = VectorSetFloat1(2.f);
+    const FVec3 QV = { Q.X, Q.Y, Q.Z };
+    FVec3 T = Cross(QV, V);
+    T = { VectorMultiply(T.X, Two), VectorMultiply(T.Y, Two), VectorMultiply(T.Z, Two) };
+    const FVec3 C = Cross(QV, T);
+    return { VectorAdd(VectorMultiplyAdd(Q.W, T.X, V.X), C.X), VectorAdd(VectorMultiplyAdd(Q.W, T.Y, V.Y), C.Y),
+        VectorAdd(VectorMultiplyAdd(Q.W, T.Z, V.Z), C.Z) };
+}
+
+// FTransform::GetSafeScaleReciprocal: zero where |S| <= SMALL_NUMBER
+FORCEINLINE VectorRegister4Float SafeReciprocal(const VectorRegister4Float& S)
+{
+    const VectorRegister4Float Mask = VectorCompareGT(VectorAbs(S), VectorSetFloat1(UE_SMALL_NUMBER));
+    return VectorSelect(Mask, VectorDivide(VectorOne(), S), VectorZero());
+}
+
+bool NeedsScalarPath(const FTransform& Bone, const FTransform& Parent)
+{
+    const FVector ParentScale = Parent.GetScale3D();
+    return Bone.GetScale3D().GetMin() < 0.0 || ParentScale.GetMin() < 0.0
+        || !ParentScale.AllComponentsEqual(UE_KINDA_SMALL_NUMBER) || !Parent.GetRotation().IsNormalized();
+}
+
+float RelativeError(float A, double B) { return float(FMath::Abs(A - B) / FMath::Max(1.0, FMath::Abs(B))); }
+} // namespace
+
+void FRetargetSoAPose::SetNum(int32 InNum)
+{
+    Num = InNum;
+    // Padding lanes hold identity transforms
+    const int32 Padded = Align(InNum, 4);
+    for (TArray<float>* Array : { &Tx, &Ty, &Tz, &Qx, &Qy, &Qz }) {
+        Array->Init(0.f, Padded);
+    }
+    for (TArray<float>* Array : { &Qw, &Sx, &Sy, &Sz }) {
+        Array->Init(1.f, Padded);
+    }
+}
+
+void FRetargetSoAPose::Set(int32 Index, const FTransform& Transform)
+{
+    const FVector T = Transform.GetTranslation();
+    const FQuat Q = Transform.GetRotation();
+    const FVector S = Transform.GetScale3D();
+    Tx[Index] = float(T.X);
+    Ty[Index] = float(T.Y);
+    Tz[Index] = float(T.Z);
+    Qx[Index] = float(Q.X);
+    Qy[Index] = float(Q.Y);
+    Qz[Index] = float(Q.Z);
+    Qw[Index] = float(Q.W);
+    Sx[Index] = float(S.X);
+    Sy[Index] = float(S.Y);
+    Sz[Index] = float(S.Z);
+}
+
+void FRetargetSimdScratch::SetNum(int32 NumBones)
+{
+    Component.SetNum(NumBones);
+    Parent.SetNum(NumBones);
+    Local.SetNum(NumBones);
+}
+
+namespace RetargetSimd {
+bool ComponentToLocal(
+    const TArray<FTransform>& ComponentPose, const TArray<int32>& ParentIndices, FRetargetSimdScratch& Scratch)
+{
+    check(ComponentPose.Num() == Scratch.Component.Num);
+
+    // Gather each bone and its parent into SoA lanes. Roots get an identity parent.
+    // The component translation lanes hold the offset from the parent, taken in double so large root
+    // translations do not lose precision when narrowed to float.
+    for (int32 BoneIndex = 0; BoneIndex < ComponentPose.Num(); ++BoneIndex) {
+        const int32 ParentIndex = ParentIndices[BoneIndex];
+        const FTransform& Bone = ComponentPose[BoneIndex];
+        const FTransform& Parent = ParentIndex == INDEX_NONE ? FTransform::Identity : ComponentPose[ParentIndex];
+        if (NeedsScalarPath(Bone, Parent)) {
+            return false;
+        }
+        Scratch.Component.Set(BoneIndex, Bone);
+        Scratch.Parent.Set(BoneIndex, Parent);
+        const FVector Delta = Bone.GetTranslation() - Parent.GetTranslation();
+        Scratch.Component.Tx[BoneIndex] = float(Delta.X);
+        Scratch.Component.Ty[BoneIndex] = float(Delta.Y);
+        Scratch.Component.Tz[BoneIndex] = float(Delta.Z);
+    }
+
+    // Local = Component.GetRelativeTransform(Parent)
+    const FRetargetSoAPose& C = Scratch.Component;
+    const FRetargetSoAPose& P = Scratch.Parent;
+    FRetargetSoAPose& L = Scratch.Local;
+    for (int32 Index = 0; Index < C.Num; Index += 4) {
+        const FQuat4 InvParentRot
+            = { VectorNegate(Load(P.Qx, Index)), VectorNegate(Load(P.Qy, Index)), VectorNegate(Load(P.Qz, Index)),
+                  Load(P.Qw, Index) };
+        const FQuat4 ChildRot = { Load(C.Qx, Index), Load(C.Qy, Index), Load(C.Qz, Index), Load(C.Qw, Index) };
+        const FVec3 RecipScale = { SafeReciprocal(Load(P.Sx, Index)), SafeReciprocal(Load(P.Sy, Index)),
+            SafeReciprocal(Load(P.Sz, Index)) };
+
+        const FQuat4 Rot = Multiply(InvParentRot, ChildRot);
+        const FVec3 Delta = { Load(C.Tx, Index), Load(C.Ty, Index), Load(C.Tz, Index) };
+        const FVec3 Trans = Rotate(InvParentRot, Delta);
+
+        VectorStore(VectorMultiply(Trans.X, RecipScale.X), L.Tx.GetData() + Index);
+        VectorStore(VectorMultiply(Trans.Y, RecipScale.Y), L.Ty.GetData() + Index);
+        VectorStore(VectorMultiply(Trans.Z, RecipScale.Z), L.Tz.GetData() + Index);
+        VectorStore(Rot.X, L.Qx.GetData() + Index);
+        VectorStore(Rot.Y, L.Qy.GetData() + Index);
+        VectorStore(Rot.Z, L.Qz.GetData() + Index);
+        VectorStore(Rot.W, L.Qw.GetData() + Index);
+        VectorStore(VectorMultiply(Load(C.Sx, Index), RecipScale.X), L.Sx.GetData() + Index);
+        VectorStore(VectorMultiply(Load(C.Sy, Index), RecipScale.Y), L.Sy.GetData() + Index);
+        VectorStore(VectorMultiply(Load(C.Sz, Index), RecipScale.Z), L.Sz.GetData() + Index);
+    }
+    return true;
+}
+
+void WriteKeys(FRetargetSimdScratch& Scratch, int32 FrameIndex, TArray<FRawAnimSequenceTrack>& BoneTracks)
+{
+    FRetargetSoAPose& L = Scratch.Local;
+
+    // FQuat::GetNormalized: identity when the squared length is below SMALL_NUMBER
+    const VectorRegister4Float Small = VectorSetFloat1(UE_SMALL_NUMBER);
+    for (int32 Index = 0; Index < L.Num; Index += 4) {
+        const VectorRegister4Float X = Load(L.Qx, Index);
+        const VectorRegister4Float Y = Load(L.Qy, Index);
+        const VectorRegister4Float Z = Load(L.Qz, Index);
+        const VectorRegister4Float W = Load(L.Qw, Index);
+        const VectorRegister4Float SquareSum = VectorMultiplyAdd(
+            X, X, VectorMultiplyAdd(Y, Y, VectorMultiplyAdd(Z, Z, VectorMultiply(W, W))));
+        const VectorRegister4Float Mask = VectorCompareGE(SquareSum, Small);
+        const VectorRegister4Float InvLength = VectorDivide(VectorOne(), VectorSqrt(SquareSum));
+        VectorStore(VectorSelect(Mask, VectorMultiply(X, InvLength), VectorZero()), L.Qx.GetData() + Index);
+        VectorStore(VectorSelect(Mask, VectorMultiply(Y, InvLength), VectorZero()), L.Qy.GetData() + Index);
+        VectorStore(VectorSelect(Mask, VectorMultiply(Z, InvLength), VectorZero()), L.Qz.GetData() + Index);
+        VectorStore(VectorSelect(Mask, VectorMultiply(W, InvLength), VectorOne()), L.Qw.GetData() + Index);
+    }
+
+    for (int32 BoneIndex = 0; BoneIndex < L.Num; ++BoneIndex) {
+        FRawAnimSequenceTrack& Track = BoneTracks[BoneIndex];
+        Track.PosKeys[FrameIndex] = FVector3f(L.Tx[BoneIndex], L.Ty[BoneIndex], L.Tz[BoneIndex]);
+        Track.RotKeys[FrameIndex] = FQuat4f(L.Qx[BoneIndex], L.Qy[BoneIndex], L.Qz[BoneIndex], L.Qw[BoneIndex]);
+        Track.ScaleKeys[FrameIndex] = FVector3f(L.Sx[BoneIndex], L.Sy[BoneIndex], L.Sz[BoneIndex]);
+    }
+}
+
+void WriteLocalKeys(const TArray<FTransform>& LocalPose, int32 FrameIndex, TArray<FRawAnimSequenceTrack>& BoneTracks)
+{
+    for (int32 BoneIndex = 0; BoneIndex < LocalPose.Num(); ++BoneIndex) {
+        const FTransform& Local = LocalPose[BoneIndex];
+        FRawAnimSequenceTrack& Track = BoneTracks[BoneIndex];
+        Track.PosKeys[FrameIndex] = FVector3f(Local.GetLocation());
+        Track.RotKeys[FrameIndex] = FQuat4f(Local.GetRotation().GetNormalized());
+        Track.ScaleKeys[FrameIndex] = FVector3f(Local.GetScale3D());
+    }
+}
+
+float MaxKeyError(const TArray<FRawAnimSequenceTrack>& BoneTracks, int32 FrameIndex, const TArray<FTransform>& LocalPose)
+{
+    float MaxError = 0.f;
+    for (int32 BoneIndex = 0; BoneIndex < LocalPose.Num(); ++BoneIndex) {
+        const FRawAnimSequenceTrack& Track = BoneTracks[BoneIndex];
+        const FVector T = LocalPose[BoneIndex].GetLocation();
+        const FQuat Q = LocalPose[BoneIndex].GetRotation().GetNormalized();
+        const FVector S = LocalPose[BoneIndex].GetScale3D();
+        const FVector3f& KeyT = Track.PosKeys[FrameIndex];
+        const FQuat4f& KeyQ = Track.RotKeys[FrameIndex];
+        const FVector3f& KeyS = Track.ScaleKeys[FrameIndex];
+        for (int32 Axis = 0; Axis < 3; ++Axis) {
+            MaxError = FMath::Max(MaxError, RelativeError(KeyT[Axis], T[Axis]));
+            MaxError = FMath::Max(MaxError, RelativeError(KeyS[Axis], S[Axis]));
+        }
+        MaxError = FMath::Max(MaxError, RelativeError(KeyQ.X, Q.X));
+        MaxError = FMath::Max(MaxError, RelativeError(KeyQ.Y, Q.Y));
+        MaxError = FMath::Max(MaxError, RelativeError(KeyQ.Z, Q.Z));
+        MaxError = FMath::Max(MaxError, RelativeError(KeyQ.W, Q.W));
+    }
+    return MaxError;
+}
+
+float MaxTrackError(const TArray<FRawAnimSequenceTrack>& A, const TArray<FRawAnimSequenceTrack>& B)
+{
+    float MaxError = 0.f;
+    for (int32 BoneIndex = 0; BoneIndex < A.Num(); ++BoneIndex) {
+        const FRawAnimSequenceTrack& TrackA = A[BoneIndex];
+        const FRawAnimSequenceTrack& TrackB = B[BoneIndex];
+        for (int32 Key = 0; Key < TrackA.PosKeys.Num(); ++Key) {
+            for (int32 Axis = 0; Axis < 3; ++Axis) {
+                MaxError = FMath::Max(MaxError, RelativeError(TrackA.PosKeys[Key][Axis], TrackB.PosKeys[Key][Axis]));
+                MaxError
+                    = FMath::Max(MaxError, RelativeError(TrackA.ScaleKeys[Key][Axis], TrackB.ScaleKeys[Key][Axis]));
+            }
+            // q and -q are the same rotation
+            const FQuat4f& QA = TrackA.RotKeys[Key];
+            const FQuat4f QB = (QA | TrackB.RotKeys[Key]) < 0.f ? TrackB.RotKeys[Key] * -1.f : TrackB.RotKeys[Key];
+            MaxError = FMath::Max(MaxError, RelativeError(QA.X, QB.X));
+            MaxError = FMath::Max(MaxError, RelativeError(QA.Y, QB.Y));
+            MaxError = FMath::Max(MaxError, RelativeError(QA.Z, QB.Z));
+            MaxError = FMath::Max(MaxError, RelativeError(QA.W, QB.W));
+        }
+    }
+    return MaxError;
+}
+} // namespace RetargetSimd
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRawAnimSequenceTrack;
+
+// One frame's transforms as float structure-of-arrays, padded to a multiple of four bones
+struct FRetargetSoAPose {
+    TArray<float> Tx, Ty, Tz;
+    TArray<float> Qx, Qy, Qz, Qw;
+    TArray<float> Sx, Sy, Sz;
+    int32 Num = 0;
+
+    void SetNum(int32 InNum);
+    void Set(int32 Index, const FTransform& Transform);
+};
+
+// Per-pair buffers for the vectorized frame kernels
+struct FRetargetSimdScratch {
+    FRetargetSoAPose Component;
+    FRetargetSoAPose Parent;
+    FRetargetSoAPose Local;
+
+    void SetNum(int32 NumBones);
+};
+
+namespace RetargetSimd {
+// Relative error above which a SIMD key is reported as not matching the scalar path
+constexpr float KeyTolerance = 1e-4f;
+
+// Component -> local conversion four bones at a time. Bones without a parent keep their component transform.
+// Returns false, leaving Scratch.Local unset, when a bone or parent has negative scale, a parent has
+// non-uniform scale or an unnormalized rotation: those poses need the scalar GetRelativeTransform path.
+bool ComponentToLocal(
+    const TArray<FTransform>& ComponentPose, const TArray<int32>& ParentIndices, FRetargetSimdScratch& Scratch);
+
+// Normalizes the local rotations and scatters the local pose into float keys at FrameIndex
+void WriteKeys(FRetargetSimdScratch& Scratch, int32 FrameIndex, TArray<FRawAnimSequenceTrack>& BoneTracks);
+
+// Scalar counterpart of WriteKeys for a local pose computed without the SIMD kernels
+void WriteLocalKeys(const TArray<FTransform>& LocalPose, int32 FrameIndex, TArray<FRawAnimSequenceTrack>& BoneTracks);
+
+// Largest relative difference between the keys at FrameIndex and a scalar local pose
+float MaxKeyError(const TArray<FRawAnimSequenceTrack>& BoneTracks, int32 FrameIndex, const TArray<FTransform>& LocalPose);
+
+// Largest relative difference between two sets of tracks of the same shape
+float MaxTrackError(const TArray<FRawAnimSequenceTrack>& A, const TArray<FRawAnimSequenceTrack>& B);
+} // namespace RetargetSimd
@@ -0,0 +1,127 @@
+#include "RetargetSocket.h"
+#include "RetargetCommandletShared.h"
+
+#if PLATFORM_UNIX
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+
+namespace {
+bool MakeAddress(const FString& SocketPath, sockaddr_un& OutAddr)
+{
+    FMemory::Memzero(OutAddr);
+    OutAddr.sun_family = AF_UNIX;
+    FTCHARToUTF8 PathUtf8(*SocketPath);
+    if (PathUtf8.Length() >= int32(sizeof(OutAddr.sun_path))) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Socket path too long: %s"), *SocketPath);
+        return false;
+    }
+    FMemory::Memcpy(OutAddr.sun_path, PathUtf8.Get(), PathUtf8.Length());
+    return true;
+}
+} // namespace
+
+bool FRetargetLineSocket::Listen(const FString& SocketPath)
+{
+    sockaddr_un Addr;
+    if (!MakeAddress(SocketPath, Addr)) {
+        return false;
+    }
+    ::unlink(Addr.sun_path);
+
+    Fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (Fd == -1 || ::bind(Fd, reinterpret_cast<sockaddr*>(&Addr), sizeof(Addr)) != 0 || ::listen(Fd, 8) != 0) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to listen on %s"), *SocketPath);
+        Close();
+        return false;
+    }
+    BoundPath = SocketPath;
+    return true;
+}
+
+bool FRetargetLineSocket::Accept(FRetargetLineSocket& OutClient)
+{
+    OutClient.Close();
+    OutClient.Fd = ::accept(Fd, nullptr, nullptr);
+    return OutClient.Fd != -1;
+}
+
+bool FRetargetLineSocket::Connect(const FString& SocketPath)
+{
+    sockaddr_un Addr;
+    if (!MakeAddress(SocketPath, Addr)) {
+        return false;
+    }
+
+    Fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (Fd == -1 || ::connect(Fd, reinterpret_cast<sockaddr*>(&Addr), sizeof(Addr)) != 0) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Failed to connect to %s"), *SocketPath);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool FRetargetLineSocket::ReadLine(FString& OutLine)
+{
+    for (;;) {
+        const int32 NewLine = Pending.Find('\n');
+        if (NewLine != INDEX_NONE) {
+            OutLine = FString(FUTF8ToTCHAR(Pending.GetData(), NewLine));
+            Pending.RemoveAt(0, NewLine + 1);
+            return true;
+        }
+
+        ANSICHAR Buffer[4096];
+        const ssize_t NumRead = ::read(Fd, Buffer, sizeof(Buffer));
+        if (NumRead <= 0) {
+            return false;
+        }
+        Pending.Append(Buffer, NumRead);
+    }
+}
+
+bool FRetargetLineSocket::WriteLine(const FString& Line)
+{
+    FTCHARToUTF8 LineUtf8(*(Line + TEXT("\n")));
+    const ANSICHAR* Data = LineUtf8.Get();
+    int32 Remaining = LineUtf8.Length();
+    while (Remaining > 0) {
+        const ssize_t NumWritten = ::write(Fd, Data, Remaining);
+        if (NumWritten <= 0) {
+            return false;
+        }
+        Data += NumWritten;
+        Remaining -= NumWritten;
+    }
+    return true;
+}
+
+void FRetargetLineSocket::Close()
+{
+    if (Fd != -1) {
+        ::close(Fd);
+        Fd = -1;
+    }
+    if (!BoundPath.IsEmpty()) {
+        ::unlink(TCHAR_TO_UTF8(*BoundPath));
+        BoundPath.Empty();
+    }
+    Pending.Reset();
+}
+#else
+bool FRetargetLineSocket::Listen(const FString&)
+{
+    UE_LOG(RetargetAllCommandlet, Error, TEXT("Unix domain sockets are not available on this platform"));
+    return false;
+}
+bool FRetargetLineSocket::Accept(FRetargetLineSocket&) { return false; }
+bool FRetargetLineSocket::Connect(const FString&)
+{
+    UE_LOG(RetargetAllCommandlet, Error, TEXT("Unix domain sockets are not available on this platform"));
+    return false;
+}
+bool FRetargetLineSocket::ReadLine(FString&) { return false; }
+bool FRetargetLineSocket::WriteLine(const FString&) { return false; }
+void FRetargetLineSocket::Close() { }
+#endif
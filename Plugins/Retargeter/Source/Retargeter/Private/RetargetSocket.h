@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Blocking, line-oriented Unix domain socket used by the worker daemon (-serve) and its clients.
+ * Lines are UTF-8 and terminated by '\n'. Only available on Unix platforms.
+ */
+class FRetargetLineSocket {
+public:
+    FRetargetLineSocket() = default;
+    ~FRetargetLineSocket() { Close(); }
+    FRetargetLineSocket(const FRetargetLineSocket&) = delete;
+    FRetargetLineSocket& operator=(const FRetargetLineSocket&) = delete;
+
+    bool Listen(const FString& SocketPath);
+    bool Accept(FRetargetLineSocket& OutClient);
+    bool Connect(const FString& SocketPath);
+
+    bool ReadLine(FString& OutLine);
+    bool WriteLine(const FString& Line);
+
+    bool IsValid() const { return Fd != -1; }
+    void Close();
+
+private:
+    int Fd = -1;
+    FString BoundPath;
+    TArray<ANSICHAR> Pending;
+};
@@ -0,0 +1,142 @@
+#include "RetargetSourcePose.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Engine/SkeletalMesh.h"
+#include "RetargetFbx.h"
+#include "Retargeter/IKRetargetProcessor.h"
+#include "RetargeterLog.h"
+
+bool FRetargetSourcePose::Initialize(
+    UAnimSequence* InAnimation, TSharedPtr<const FRetargetFbxClip> InClip, const FRetargetSkeleton& SourceRig)
+{
+    Animation = InAnimation;
+    Clip = InClip;
+
+    const int32 NumBones = SourceRig.BoneNames.Num();
+    ParentIndices = SourceRig.ParentIndices;
+    PoseIndices.SetNumUninitialized(NumBones);
+    LocalPose.SetNumUninitialized(NumBones);
+    RefLocalPose.SetNumUninitialized(NumBones);
+
+    const USkeletalMesh* Mesh = SourceRig.SkeletalMesh;
+    if (!Mesh || (!Animation && !Clip)) {
+        UE_LOG(Retargeter, Error, TEXT("SourcePose: missing source mesh or animation"));
+        return false;
+    }
+    const FReferenceSkeleton& MeshRefSkeleton = Mesh->GetRefSkeleton();
+    const FReferenceSkeleton& PoseRefSkeleton = Clip ? Clip->RefSkeleton : MeshRefSkeleton;
+
+    if (!Clip) {
+        // All mesh bones, evaluated from the raw data model so no compressed data is needed
+        TArray<FBoneIndexType> RequiredBones;
+        RequiredBones.SetNumUninitialized(MeshRefSkeleton.GetNum());
+        for (int32 BoneIndex = 0; BoneIndex < RequiredBones.Num(); ++BoneIndex) {
+            RequiredBones[BoneIndex] = FBoneIndexType(BoneIndex);
+        }
+        BoneContainer.InitializeTo(RequiredBones,
+            UE::Anim::FCurveFilterSettings(UE::Anim::ECurveFilterMode::DisallowAll), *const_cast<USkeletalMesh*>(Mesh));
+        BoneContainer.SetUseRAWData(true);
+        CompactPose.SetBoneContainer(&BoneContainer);
+        Curve.InitFrom(BoneContainer);
+    }
+
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        if (ParentIndices[BoneIndex] >= BoneIndex) {
+            UE_LOG(Retargeter, Error, TEXT("SourcePose: bone %s is ordered before its parent"),
+                *SourceRig.BoneNames[BoneIndex].ToString());
+            return false;
+        }
+
+        const int32 RefIndex = PoseRefSkeleton.FindBoneIndex(SourceRig.BoneNames[BoneIndex]);
+        RefLocalPose[BoneIndex] = RefIndex != INDEX_NONE ? PoseRefSkeleton.GetRefBonePose()[RefIndex] : FTransform::Identity;
+        if (Clip || RefIndex == INDEX_NONE) {
+            PoseIndices[BoneIndex] = RefIndex;
+        } else {
+            PoseIndices[BoneIndex] = BoneContainer.MakeCompactPoseIndex(FMeshPoseBoneIndex(RefIndex)).GetInt();
+        }
+    }
+    return true;
+}
+
+void FRetargetSourcePose::Evaluate(int32 FrameIndex, TArray<FTransform>& OutComponentPose)
+{
+    const int32 NumBones = PoseIndices.Num();
+    OutComponentPose.SetNumUninitialized(NumBones, EAllowShrinking::No);
+
+    if (Clip) {
+        const FTransform* ClipPose = Clip->GetFrame(FrameIndex);
+        for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+            const int32 PoseIndex = PoseIndices[BoneIndex];
+            LocalPose[BoneIndex] = PoseIndex != INDEX_NONE ? ClipPose[PoseIndex] : RefLocalPose[BoneIndex];
+        }
+    } else {
+        // Root motion stays in the pose, as with the previous bIncorporateRootMotionIntoPose evaluation
+        FAnimationPoseData PoseData(CompactPose, Curve, Attributes);
+        const FAnimExtractContext Context(double(Animation->GetTimeAtFrame(FrameIndex)), /*bExtractRootMotion*/ false);
+        Animation->GetAnimationPose(PoseData, Context);
+
+        for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+            const int32 PoseIndex = PoseIndices[BoneIndex];
+            LocalPose[BoneIndex]
+                = PoseIndex != INDEX_NONE ? CompactPose[FCompactPoseBoneIndex(PoseIndex)] : RefLocalPose[BoneIndex];
+        }
+    }
+
+    // Parents precede children, so one pass gives component space
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        const int32 ParentIndex = ParentIndices[BoneIndex];
+        OutComponentPose[BoneIndex]
+            = ParentIndex == INDEX_NONE ? LocalPose[BoneIndex] : LocalPose[BoneIndex] * OutComponentPose[ParentIndex];
+    }
+}
+
+TSharedPtr<const FRetargetFbxClip> FRetargetSourcePose::BakeClip(UAnimSequence* Animation, USkeletalMesh* Mesh)
+{
+    check(IsInGameThread());
+    if (!Animation || !Mesh) {
+        return nullptr;
+    }
+
+    TSharedRef<FRetargetFbxClip> Clip = MakeShared<FRetargetFbxClip>();
+    Clip->RefSkeleton = Mesh->GetRefSkeleton();
+    Clip->FrameRate = Animation->GetDataModel()->GetFrameRate();
+    Clip->NumFrames = Animation->GetDataModel()->GetNumberOfFrames();
+    const int32 NumBones = Clip->NumBones();
+
+    TArray<FBoneIndexType> RequiredBones;
+    RequiredBones.SetNumUninitialized(NumBones);
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        RequiredBones[BoneIndex] = FBoneIndexType(BoneIndex);
+    }
+    FBoneContainer BoneContainer;
+    BoneContainer.InitializeTo(
+        RequiredBones, UE::Anim::FCurveFilterSettings(UE::Anim::ECurveFilterMode::DisallowAll), *Mesh);
+    BoneContainer.SetUseRAWData(true);
+    FCompactPose Pose;
+    Pose.SetBoneContainer(&BoneContainer);
+    FBlendedCurve Curve;
+    Curve.InitFrom(BoneContainer);
+    UE::Anim::FStackAttributeContainer Attributes;
+
+    // Same evaluation as Evaluate, stored in mesh bone order
+    Clip->LocalPoses.SetNumUninitialized(Clip->NumFrames * NumBones);
+    for (int32 FrameIndex = 0; FrameIndex < Clip->NumFrames; ++FrameIndex) {
+        FAnimationPoseData PoseData(Pose, Curve, Attributes);
+        const FAnimExtractContext Context(double(Animation->GetTimeAtFrame(FrameIndex)), /*bExtractRootMotion*/ false);
+        Animation->GetAnimationPose(PoseData, Context);
+        FTransform* Frame = &Clip->LocalPoses[FrameIndex * NumBones];
+        for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+            Frame[BoneIndex] = Pose[BoneContainer.MakeCompactPoseIndex(FMeshPoseBoneIndex(BoneIndex))];
+        }
+    }
+    return Clip;
+}
+
+float FRetargetSourcePose::GetDeltaTime(int32 FrameIndex) const
+{
+    if (Clip) {
+        return (FrameIndex > 0) ? float(Clip->FrameRate.AsInterval()) : 0.f;
+    }
+    const float TimeAtFrame = Animation->GetTimeAtFrame(FrameIndex);
+    return (FrameIndex > 0) ? TimeAtFrame - Animation->GetTimeAtFrame(FrameIndex - 1) : TimeAtFrame;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Animation/AttributesRuntime.h"
+#include "BoneContainer.h"
+#include "BonePose.h"
+
+class UAnimSequence;
+class USkeletalMesh;
+struct FRetargetFbxClip;
+struct FRetargetSkeleton;
+
+/**
+ * Evaluates source frames into a component-space buffer in source rig bone order.
+ * The source bone -> pose bone remap is built once per pair; each frame is one bulk pose
+ * evaluation followed by a single parent-before-child accumulation pass.
+ */
+class FRetargetSourcePose {
+public:
+    // Either Animation or Clip provides the frames
+    bool Initialize(UAnimSequence* InAnimation, TSharedPtr<const FRetargetFbxClip> InClip,
+        const FRetargetSkeleton& SourceRig);
+    void Evaluate(int32 FrameIndex, TArray<FTransform>& OutComponentPose);
+
+    // Time step from the previous frame, as passed to the retargeter
+    float GetDeltaTime(int32 FrameIndex) const;
+
+    // Evaluates every frame of Animation into a clip indexed like Mesh's reference skeleton. Game thread only;
+    // the clip can then be evaluated on any thread.
+    static TSharedPtr<const FRetargetFbxClip> BakeClip(UAnimSequence* Animation, USkeletalMesh* Mesh);
+
+private:
+    UAnimSequence* Animation = nullptr;
+    TSharedPtr<const FRetargetFbxClip> Clip;
+
+    // Per source rig bone: index into the evaluated pose (compact pose or clip frame), and parent rig bone
+    TArray<int32> PoseIndices;
+    TArray<int32> ParentIndices;
+    TArray<FTransform> RefLocalPose;
+    TArray<FTransform> LocalPose;
+
+    FBoneContainer BoneContainer;
+    FCompactPose CompactPose;
+    FBlendedCurve Curve;
+    UE::Anim::FStackAttributeContainer Attributes;
+};
@@ -0,0 +1,122 @@
+#include "RetargetWorkQueue.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RetargetCommandletShared.h"
+
+#if PLATFORM_UNIX
+#  include <fcntl.h>
+#  include <sys/file.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+const TCHAR* PairsFileName = TEXT("pairs.tsv");
+const TCHAR* CounterFileName = TEXT("next");
+} // namespace
+
+bool FRetargetWorkQueue::Write(const FString& QueueDir, const TArray<FRetargetPair>& Pairs)
+{
+    IFileManager::Get().MakeDirectory(*QueueDir, /*Tree*/ true);
+
+    TArray<FString> Lines;
+    Lines.Reserve(Pairs.Num());
+    for (const FRetargetPair& Pair : Pairs) {
+        Lines.Add(FString::Printf(TEXT("%d\t%s\t%s\t%s\t%s"), Pair.JobIndex, *Pair.AnimationFile, *Pair.SkeletonFile,
+            *Pair.OutputFile, *Pair.Key));
+    }
+
+    return FFileHelper::SaveStringArrayToFile(Lines, *FPaths::Combine(QueueDir, PairsFileName))
+        && FFileHelper::SaveStringToFile(TEXT("0"), *FPaths::Combine(QueueDir, CounterFileName));
+}
+
+void FRetargetWorkQueue::Remove(const FString& QueueDir)
+{
+    if (!IFileManager::Get().DeleteDirectory(*QueueDir, false, true)) {
+        UE_LOG(RetargetAllCommandlet, Warning, TEXT("Queue: failed to remove %s"), *QueueDir);
+    }
+}
+
+bool FRetargetWorkQueue::Open(const FString& QueueDir, int32 InWorkerIndex, int32 InNumWorkers)
+{
+    WorkerIndex = InWorkerIndex;
+    NumWorkers = FMath::Max(1, InNumWorkers);
+    CounterFile = FPaths::Combine(QueueDir, CounterFileName);
+    Jobs.Reset();
+
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *FPaths::Combine(QueueDir, PairsFileName))) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Queue: failed to read %s"), *QueueDir);
+        return false;
+    }
+
+    for (const FString& Line : Lines) {
+        TArray<FString> Fields;
+        Line.ParseIntoArray(Fields, TEXT("\t"), /*CullEmpty*/ false);
+        if (Fields.Num() != 4 && Fields.Num() != 5) {
+            continue;
+        }
+        FRetargetPair Pair;
+        Pair.JobIndex = FCString::Atoi(*Fields[0]);
+        Pair.AnimationFile = Fields[1];
+        Pair.SkeletonFile = Fields[2];
+        Pair.OutputFile = Fields[3];
+        Pair.Key = Fields.IsValidIndex(4) ? Fields[4] : FString();
+        if (Pair.JobIndex < 0) {
+            continue;
+        }
+        if (Jobs.Num() <= Pair.JobIndex) {
+            Jobs.SetNum(Pair.JobIndex + 1);
+        }
+        Jobs[Pair.JobIndex].Add(MoveTemp(Pair));
+    }
+    return true;
+}
+
+bool FRetargetWorkQueue::ClaimNextJob(TArray<FRetargetPair>& OutPairs)
+{
+    OutPairs.Reset();
+    while (OutPairs.Num() == 0) {
+        const int32 JobIndex = ClaimNextJobIndex();
+        if (!Jobs.IsValidIndex(JobIndex)) {
+            return false;
+        }
+        OutPairs = Jobs[JobIndex];
+    }
+    return true;
+}
+
+#if PLATFORM_UNIX
+int32 FRetargetWorkQueue::ClaimNextJobIndex()
+{
+    // flock is released by the kernel if a worker dies while holding it
+    int Fd = ::open(TCHAR_TO_UTF8(*CounterFile), O_RDWR);
+    if (Fd == -1) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Queue: failed to open counter %s"), *CounterFile);
+        return INDEX_NONE;
+    }
+
+    int32 JobIndex = INDEX_NONE;
+    if (::flock(Fd, LOCK_EX) == 0) {
+        char Buffer[32] = {};
+        const ssize_t NumRead = ::pread(Fd, Buffer, sizeof(Buffer) - 1, 0);
+        JobIndex = NumRead > 0 ? atoi(Buffer) : 0;
+
+        const int32 Len = FCStringAnsi::Snprintf(Buffer, sizeof(Buffer), "%d", JobIndex + 1);
+        if (::ftruncate(Fd, 0) != 0 || ::pwrite(Fd, Buffer, Len, 0) != Len) {
+            UE_LOG(RetargetAllCommandlet, Error, TEXT("Queue: failed to update counter %s"), *CounterFile);
+            JobIndex = INDEX_NONE;
+        }
+        ::flock(Fd, LOCK_UN);
+    }
+    ::close(Fd);
+    return JobIndex;
+}
+#else
+int32 FRetargetWorkQueue::ClaimNextJobIndex()
+{
+    // No shared counter on this platform: fall back to static striding over jobs
+    NextStaticJob = (NextStaticJob == INDEX_NONE) ? WorkerIndex : NextStaticJob + NumWorkers;
+    return NextStaticJob;
+}
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One animation/skeleton pair. Pairs sharing a JobIndex are claimed together by one worker.
+struct FRetargetPair {
+    int32 JobIndex = 0;
+    FString AnimationFile;
+    FString SkeletonFile;
+    FString OutputFile;
+    // Manifest key recorded once OutputFile is written; empty disables recording
+    FString Key;
+};
+
+/**
+ * Pair list shared by worker processes through a queue directory.
+ * Jobs are claimed dynamically by bumping a counter file under an exclusive lock.
+ */
+class FRetargetWorkQueue {
+public:
+    static bool Write(const FString& QueueDir, const TArray<FRetargetPair>& Pairs);
+
+    // Deletes the queue directory once every worker reading it has exited
+    static void Remove(const FString& QueueDir);
+
+    bool Open(const FString& QueueDir, int32 InWorkerIndex, int32 InNumWorkers);
+
+    // Claims the next unprocessed job. Returns false once the queue is drained.
+    bool ClaimNextJob(TArray<FRetargetPair>& OutPairs);
+
+    int32 NumJobs() const { return Jobs.Num(); }
+
+private:
+    int32 ClaimNextJobIndex();
+
+    TArray<TArray<FRetargetPair>> Jobs;
+    FString CounterFile;
+    int32 WorkerIndex = 0;
+    int32 NumWorkers = 1;
+    int32 NextStaticJob = INDEX_NONE;
+};
@@ -12,22 +12,37 @@
 #include "CoreGlobals.h"
 #include "Misc/ScopeExit.h"
 #include "Misc/CoreMisc.h"
+#include "RetargetSocket.h"
+#include "RetargetWorkQueue.h"
+#include "RetargetManifest.h"
+#include "RetargetSimd.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "HAL/PlatformProcess.h"
 
 URetargetWorkerCommandlet::URetargetWorkerCommandlet() { LogToConsole = false; }
 
 int32 URetargetWorkerCommandlet::Main(const FString& Params)
 {
-    FString BasePath, SubDir;
+    FString BasePath, SubDir, QueueDir;
     int32 WorkerIndex = -1, NumWorkers = -1, Seed = 0;
 
-    if (!FParse::Value(*Params, TEXT("input="), BasePath) || BasePath.IsEmpty()) {
-        UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -input=<base folder path>"));
+    if (!ApplyOptions(Params)) {
         return 1;
     }
-    if (!FParse::Value(*Params, TEXT("subdir="), SubDir) || SubDir.IsEmpty()) {
-        UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -subdir=<train|val|test>"));
-        return 1;
+
+    // Daemon mode: stay resident and take jobs over a Unix domain socket
+    if (FParse::Param(*Params, TEXT("serve"))) {
+        FString SocketPath;
+        if (!FParse::Value(*Params, TEXT("socket="), SocketPath) || SocketPath.IsEmpty()) {
+            SocketPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(),
+                TEXT("Workers"), FString::Printf(TEXT("retarget_%d.sock"), FPlatformProcess::GetCurrentProcessId())));
+        }
+        return Serve(SocketPath);
     }
+
     if (!FParse::Value(*Params, TEXT("workerindex="), WorkerIndex)) {
         UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -workerindex=<index>"));
         return 1;
@@ -36,7 +51,23 @@ int32 URetargetWorkerCommandlet::Main(const FString& Params)
         UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -numworkers=<total>"));
         return 1;
     }
-    
+
+    // Queue mode: pairs are claimed dynamically from a queue written by RetargetAll0
+    if (FParse::Value(*Params, TEXT("queue="), QueueDir) && !QueueDir.IsEmpty()) {
+        UE_LOG(RetargetAllCommandlet, Log, TEXT("Worker %d/%d processing queue %s"), WorkerIndex, NumWorkers, *QueueDir);
+        ProcessQueue(QueueDir, WorkerIndex, NumWorkers);
+        return 0;
+    }
+
+    if (!FParse::Value(*Params, TEXT("input="), BasePath) || BasePath.IsEmpty()) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -input=<base folder path>"));
+        return 1;
+    }
+    if (!FParse::Value(*Params, TEXT("subdir="), SubDir) || SubDir.IsEmpty()) {
+        UE_LOG(RetargetAllCommandlet, Error, TEXT("Worker: Missing required argument: -subdir=<train|val|test>"));
+        return 1;
+    }
+
     // Parse optional seed parameter (default to 0)
     FParse::Value(*Params, TEXT("seed="), Seed);
     UE_LOG(RetargetAllCommandlet, Log, TEXT("Worker %d using seed: %d"), WorkerIndex, Seed);
@@ -60,10 +91,295 @@ int32 URetargetWorkerCommandlet::Main(const FString& Params)
     UE_LOG(RetargetAllCommandlet, Log, TEXT("Worker %d/%d processing %s in %s"), WorkerIndex, NumWorkers, *SubDir, *BasePath);
 
     ProcessDirectory(BasePath, SubDir, WorkerIndex, NumWorkers, Seed);
+    FRetargeterModule::Get().CloseShards();
 
     return 0;
 }
 
+bool URetargetWorkerCommandlet::ApplyOptions(const FString& Params)
+{
+    // Optional asset cache budgets (MB) and test/val traversal order
+    int32 SourceCacheMB = 1024, TargetCacheMB = 0;
+    FParse::Value(*Params, TEXT("sourcecachemb="), SourceCacheMB);
+    FParse::Value(*Params, TEXT("targetcachemb="), TargetCacheMB);
+    bAnimationMajor = FParse::Param(*Params, TEXT("animmajor"));
+    FanOut = 8;
+    FParse::Value(*Params, TEXT("fanout="), FanOut);
+    FanOut = FMath::Max(1, FanOut);
+    if (bAnimationMajor && !FParse::Value(*Params, TEXT("targetcachemb="), TargetCacheMB)) {
+        TargetCacheMB = 1024;
+    }
+    FRetargeterModule::Get().SetDirectFbxImport(FParse::Param(*Params, TEXT("directfbx")));
+    FRetargeterModule::Get().SetDirectFbxExport(FParse::Param(*Params, TEXT("directexport")));
+    const bool bReduceKeys = FParse::Param(*Params, TEXT("reducekeys"));
+    if (bReduceKeys && !FParse::Param(*Params, TEXT("directexport"))) {
+        UE_LOG(RetargetAllCommandlet, Warning,
+            TEXT("Worker: -reducekeys only applies with -directexport, ignoring it"));
+    }
+    FRetargeterModule::Get().SetReduceKeys(bReduceKeys && FParse::Param(*Params, TEXT("directexport")));
+    FRetargeterModule::Get().SetSkipCompression(FParse::Param(*Params, TEXT("nocompress")));
+    FRetargeterModule::Get().SetCountAllocations(FParse::Param(*Params, TEXT("countallocs")));
+    FRetargeterModule::Get().SetValidateSimd(FParse::Param(*Params, TEXT("validatesimd")));
+    FRetargeterModule::Get().SetScalarLocal(FParse::Param(*Params, TEXT("scalarlocal")));
+    FRetargeterModule::Get().SetValidateChunks(FParse::Param(*Params, TEXT("validatechunks")));
+
+    int32 PipelineDepth = 1;
+    FParse::Value(*Params, TEXT("pipelinedepth="), PipelineDepth);
+    FRetargeterModule::Get().SetPipelineDepth(PipelineDepth);
+
+    // Without -gceverypairs, a memory or object threshold replaces the per-pair collection
+    int32 GCRssMB = 0, GCObjects = 0;
+    FParse::Value(*Params, TEXT("gcrssmb="), GCRssMB);
+    FParse::Value(*Params, TEXT("gcobjects="), GCObjects);
+    int32 GCEveryPairs = (GCRssMB > 0 || GCObjects > 0) ? 0 : 1;
+    FParse::Value(*Params, TEXT("gceverypairs="), GCEveryPairs);
+    FRetargeterModule::Get().SetGCPolicy(GCRssMB, GCObjects, GCEveryPairs);
+
+    FString MetricsRun;
+    FParse::Value(*Params, TEXT("metrics="), MetricsRun);
+    FRetargeterModule::Get().SetMetricsOutput(MetricsRun);
+
+    // Optional parallel frame chunks for long clips: -framechunk=<frames> [-chunkwarmup=16]
+    int32 FrameChunk = 0, ChunkWarmup = 16;
+    FParse::Value(*Params, TEXT("framechunk="), FrameChunk);
+    FParse::Value(*Params, TEXT("chunkwarmup="), ChunkWarmup);
+    FRetargeterModule::Get().SetFrameChunking(FrameChunk, ChunkWarmup);
+    FRetargeterModule::Get().SetSourceCacheBudgetMB(SourceCacheMB);
+    FRetargeterModule::Get().SetTargetCacheBudgetMB(TargetCacheMB);
+
+    // Optional shard sink: -sink=shard [-shardencoding=float32|float16|snorm16] [-shardmb=1024]
+    FString Sink, ShardEncoding;
+    int32 ShardMB = 1024;
+    if (FParse::Value(*Params, TEXT("sink="), Sink) && Sink == TEXT("shard")) {
+        ShardEncoding = TEXT("float32");
+        FParse::Value(*Params, TEXT("shardencoding="), ShardEncoding);
+        FParse::Value(*Params, TEXT("shardmb="), ShardMB);
+    }
+    if (!FRetargeterModule::Get().SetShardOutput(ShardEncoding, ShardMB)) {
+        return false;
+    }
+
+    AppliedOptions = Params;
+    return true;
+}
+
+int32 URetargetWorkerCommandlet::Serve(const FString& SocketPath)
+{
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(SocketPath), /*Tree*/ true);
+
+    FRetargetLineSocket Listener;
+    if (!Listener.Listen(SocketPath)) {
+        return 3;
+    }
+    UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker serving on %s"), *SocketPath);
+
+    FRetargeterModule::Get().SetPersistAssets(false);
+
+    // One client at a time; the daemon keeps running between clients until asked to quit
+    bool bQuit = false;
+    FRetargetLineSocket Client;
+    while (!bQuit && Listener.Accept(Client)) {
+        FString Line;
+        while (!bQuit && Client.ReadLine(Line)) {
+            if (Line.TrimStartAndEnd().IsEmpty()) {
+                continue;
+            }
+            const FString Reply = HandleRequest(Line, bQuit);
+            if (!Client.WriteLine(Reply)) {
+                break;
+            }
+        }
+        Client.Close();
+    }
+    FRetargeterModule::Get().CloseShards();
+
+    UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker stopped serving on %s"), *SocketPath);
+    return 0;
+}
+
+FString URetargetWorkerCommandlet::HandleRequest(const FString& Line, bool& bOutQuit)
+{
+    TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+    auto Serialize = [&Reply]() {
+        FString Out;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer
+            = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Out);
+        FJsonSerializer::Serialize(Reply, Writer);
+        return Out;
+    };
+
+    TSharedPtr<FJsonObject> Request;
+    TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(Line);
+    if (!FJsonSerializer::Deserialize(Reader, Request) || !Request.IsValid()) {
+        Reply->SetBoolField(TEXT("ok"), false);
+        Reply->SetStringField(TEXT("error"), TEXT("invalid json"));
+        return Serialize();
+    }
+
+    const FString Cmd = Request->GetStringField(TEXT("cmd"));
+    Reply->SetStringField(TEXT("cmd"), Cmd);
+    FRetargeterModule& Retargeter = FRetargeterModule::Get();
+
+    // The coordinator's worker options replace the ones this daemon was started with
+    FString Options;
+    if (Request->TryGetStringField(TEXT("options"), Options) && Options != AppliedOptions) {
+        UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker: applying options%s"), *Options);
+        if (!ApplyOptions(Options)) {
+            Reply->SetBoolField(TEXT("ok"), false);
+            Reply->SetStringField(TEXT("error"), TEXT("invalid options"));
+            return Serialize();
+        }
+    }
+
+    if (Cmd == TEXT("ping")) {
+        Reply->SetBoolField(TEXT("ok"), true);
+    } else if (Cmd == TEXT("quit")) {
+        bOutQuit = true;
+        Reply->SetBoolField(TEXT("ok"), true);
+    } else if (Cmd == TEXT("retarget")) {
+        // Either a single target/output or parallel targets/outputs arrays
+        const FString InputFbx = Request->GetStringField(TEXT("input"));
+        TArray<FString> Targets, Outputs;
+        FString Target, Output;
+        if (Request->TryGetStringField(TEXT("target"), Target) && Request->TryGetStringField(TEXT("output"), Output)) {
+            Targets.Add(Target);
+            Outputs.Add(Output);
+        } else {
+            Request->TryGetStringArrayField(TEXT("targets"), Targets);
+            Request->TryGetStringArrayField(TEXT("outputs"), Outputs);
+        }
+
+        if (InputFbx.IsEmpty() || Targets.Num() == 0 || Targets.Num() != Outputs.Num()) {
+            Reply->SetBoolField(TEXT("ok"), false);
+            Reply->SetStringField(TEXT("error"), TEXT("expected input and target/output or targets/outputs"));
+            return Serialize();
+        }
+
+        // Shard output leaves no file behind, so success comes from the retarget calls
+        const int32 NumWritten = Targets.Num() == 1
+            ? (Retargeter.RetargetAPair(InputFbx, Targets[0], Outputs[0]) ? 1 : 0)
+            : Retargeter.RetargetOneToMany(InputFbx, Targets, Outputs);
+        Reply->SetBoolField(TEXT("ok"), NumWritten == Outputs.Num());
+        Reply->SetNumberField(TEXT("written"), NumWritten);
+    } else if (Cmd == TEXT("queue")) {
+        const FString QueueDir = Request->GetStringField(TEXT("path"));
+        const int32 WorkerIndex = Request->GetIntegerField(TEXT("workerindex"));
+        const int32 NumWorkers = Request->GetIntegerField(TEXT("numworkers"));
+        const int32 NumWritten = ProcessQueue(QueueDir, WorkerIndex, NumWorkers);
+        Reply->SetBoolField(TEXT("ok"), NumWritten >= 0);
+        Reply->SetNumberField(TEXT("written"), FMath::Max(0, NumWritten));
+    } else {
+        Reply->SetBoolField(TEXT("ok"), false);
+        Reply->SetStringField(TEXT("error"), FString::Printf(TEXT("unknown cmd '%s'"), *Cmd));
+    }
+    return Serialize();
+}
+
+int32 URetargetWorkerCommandlet::ProcessQueue(const FString& QueueDir, int32 WorkerIndex, int32 NumWorkers)
+{
+    LOG_SCOPE_VERBOSITY_OVERRIDE(Retargeter, ELogVerbosity::NoLogging);
+    FScopedScriptExceptionHandler ScriptLogFilter(
+        [](ELogVerbosity::Type Verbosity, const TCHAR* ExceptionMessage, const TCHAR* StackMessage) {
+            if (Verbosity == ELogVerbosity::Display) return;
+            FScriptExceptionHandler::LoggingExceptionHandler(Verbosity, ExceptionMessage, StackMessage);
+        });
+
+    FRetargetWorkQueue Queue;
+    if (!Queue.Open(QueueDir, WorkerIndex, NumWorkers)) {
+        return INDEX_NONE;
+    }
+
+    FRetargeterModule& Retargeter = FRetargeterModule::Get();
+    Retargeter.SetPersistAssets(false);
+
+    TArray<FRetargetPair> Pairs;
+    int32 NumWritten = 0;
+    while (Queue.ClaimNextJob(Pairs)) {
+        UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker %d: Processing job %d/%d (%d pairs)"), WorkerIndex,
+            Pairs[0].JobIndex + 1, Queue.NumJobs(), Pairs.Num());
+        NumWritten += ProcessJob(Pairs);
+    }
+
+    Retargeter.ReleaseSourceCache();
+    Retargeter.ReleaseTargetCache();
+    Retargeter.CloseShards();
+    return NumWritten;
+}
+
+int32 URetargetWorkerCommandlet::ProcessJob(const TArray<FRetargetPair>& Pairs)
+{
+    FRetargeterModule& Retargeter = FRetargeterModule::Get();
+
+    // Stale outputs of pairs being redone must not be taken as written. Shard output leaves FBX files alone.
+    const bool bWritesFiles = !Retargeter.UsesShardOutput();
+    if (bWritesFiles) {
+        for (const FRetargetPair& Pair : Pairs) {
+            IFileManager::Get().Delete(*Pair.OutputFile, /*RequireExists*/ false, /*EvenReadOnly*/ true);
+        }
+    }
+
+    // A job sharing one animation is fanned out from a single source evaluation
+    const bool bSharedAnimation = Pairs.Num() > 1
+        && !Pairs.ContainsByPredicate(
+            [&Pairs](const FRetargetPair& Pair) { return Pair.AnimationFile != Pairs[0].AnimationFile; });
+    int32 NumWritten = 0;
+    if (bSharedAnimation) {
+        TArray<FString> Targets, Outputs;
+        for (const FRetargetPair& Pair : Pairs) {
+            Targets.Add(Pair.SkeletonFile);
+            Outputs.Add(Pair.OutputFile);
+        }
+        NumWritten = Retargeter.RetargetOneToMany(Pairs[0].AnimationFile, Targets, Outputs);
+    } else {
+        TArray<FString> Animations, Targets, Outputs;
+        for (const FRetargetPair& Pair : Pairs) {
+            Animations.Add(Pair.AnimationFile);
+            Targets.Add(Pair.SkeletonFile);
+            Outputs.Add(Pair.OutputFile);
+        }
+        NumWritten = Retargeter.RetargetPairs(Animations, Targets, Outputs);
+    }
+
+    if (bWritesFiles) {
+        for (const FRetargetPair& Pair : Pairs) {
+            FRetargetManifest::Append(Pair.OutputFile, Pair.Key);
+        }
+    }
+
+    uint64 TotalAllocs = 0, MaxAllocs = 0;
+    int32 NumFrames = 0;
+    if (Retargeter.ConsumeFrameAllocations(TotalAllocs, MaxAllocs, NumFrames) && NumFrames > 0) {
+        UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker: %llu heap allocations over %d frames (%.2f/frame, max %llu)"),
+            TotalAllocs, NumFrames, double(TotalAllocs) / NumFrames, MaxAllocs);
+    }
+
+    const FRetargetGCStats GCStats = Retargeter.ConsumeGCStats();
+    if (GCStats.NumCollections > 0) {
+        UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker: %d GCs over %d pairs, %.1f ms, reclaimed %.1f MB and %d objects"),
+            GCStats.NumCollections, GCStats.NumPairs, GCStats.Seconds * 1000.0,
+            GCStats.ReclaimedBytes / (1024.0 * 1024.0), GCStats.ReclaimedObjects);
+    }
+
+    float SimdError = 0.f;
+    if (Retargeter.ConsumeSimdError(SimdError)) {
+        if (SimdError > RetargetSimd::KeyTolerance) {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("Worker: SIMD keys differ from the scalar path by %g"), SimdError);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker: SIMD keys match the scalar path (max error %g)"), SimdError);
+        }
+    }
+
+    float ChunkError = 0.f;
+    if (Retargeter.ConsumeChunkError(ChunkError)) {
+        if (ChunkError > RetargetSimd::KeyTolerance) {
+            UE_LOG(RetargetAllCommandlet, Warning, TEXT("Worker: chunked keys differ from sequential ones by %g"), ChunkError);
+        } else {
+            UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker: chunked keys match sequential ones (max error %g)"), ChunkError);
+        }
+    }
+    return NumWritten;
+}
+
 void URetargetWorkerCommandlet::ProcessDirectory(const FString& BasePath, const FString& SubDir, int32 WorkerIndex, int32 NumWorkers, int32 Seed)
 {
     LOG_SCOPE_VERBOSITY_OVERRIDE(Retargeter, ELogVerbosity::NoLogging);
@@ -92,8 +408,8 @@ void URetargetWorkerCommandlet::ProcessTrainDirectory(const FString& TrainPath,
     const FString AnimationPath = FPaths::Combine(TrainPath, TEXT("Animation"));
     const FString RetargetPath = FPaths::Combine(TrainPath, TEXT("Retarget"));
 
-    TArray<FString> SkeletonFiles = GetFBXFiles(CharacterPath);
-    TArray<FString> AnimationFiles = GetFBXFiles(AnimationPath);
+    TArray<FString> SkeletonFiles = RetargetCommandlet::GetFBXFiles(CharacterPath);
+    TArray<FString> AnimationFiles = RetargetCommandlet::GetFBXFiles(AnimationPath);
 
     if (SkeletonFiles.Num() == 0 || AnimationFiles.Num() == 0) return;
 
@@ -113,7 +429,8 @@ void URetargetWorkerCommandlet::ProcessTrainDirectory(const FString& TrainPath,
         
         // Generate a unique seed for this skeleton based on its index
         int32 SkeletonSeed = RandomStream.GetCurrentSeed() + SkeletonIdx;
-        TArray<FString> RandomAnimations = GetRandomSubset(AnimationFiles, MaxAnimations, SkeletonSeed);
+        TArray<FString> RandomAnimations
+            = RetargetCommandlet::GetRandomSubset(AnimationFiles, MaxAnimations, SkeletonSeed);
 
         for (const FString& AnimationFile : RandomAnimations) {
             const FString AnimationName = FPaths::GetBaseFilename(AnimationFile);
@@ -121,6 +438,7 @@ void URetargetWorkerCommandlet::ProcessTrainDirectory(const FString& TrainPath,
             const FString OutputFile = FPaths::Combine(RetargetPath, PrefixedName);
             Retargeter.RetargetAPair(AnimationFile, SkeletonFile, OutputFile);
         }
+        Retargeter.ReleaseTargetCache();
     }
 }
 
@@ -130,8 +448,8 @@ void URetargetWorkerCommandlet::ProcessTestValDirectory(const FString& DirPath,
     const FString AnimationPath = FPaths::Combine(DirPath, TEXT("Animation"));
     const FString RetargetPath = FPaths::Combine(DirPath, TEXT("Retarget"));
 
-    TArray<FString> SkeletonFiles = GetFBXFiles(CharacterPath);
-    TArray<FString> AnimationFiles = GetFBXFiles(AnimationPath);
+    TArray<FString> SkeletonFiles = RetargetCommandlet::GetFBXFiles(CharacterPath);
+    TArray<FString> AnimationFiles = RetargetCommandlet::GetFBXFiles(AnimationPath);
 
     if (SkeletonFiles.Num() == 0 || AnimationFiles.Num() == 0) return;
 
@@ -141,6 +459,36 @@ void URetargetWorkerCommandlet::ProcessTestValDirectory(const FString& DirPath,
     FRetargeterModule& Retargeter = FRetargeterModule::Get();
     Retargeter.SetPersistAssets(false);
 
+    if (bAnimationMajor) {
+        // Each animation is imported once and fanned out to every skeleton this worker owns
+        TArray<FString> OwnedSkeletons;
+        for (int32 SkeletonIdx = WorkerIndex; SkeletonIdx < SkeletonFiles.Num(); SkeletonIdx += NumWorkers) {
+            OwnedSkeletons.Add(SkeletonFiles[SkeletonIdx]);
+        }
+
+        for (int32 AnimationIdx = 0; AnimationIdx < AnimationFiles.Num(); ++AnimationIdx) {
+            const FString& AnimationFile = AnimationFiles[AnimationIdx];
+            const FString AnimationName = FPaths::GetBaseFilename(AnimationFile);
+
+            UE_LOG(RetargetAllCommandlet, Display, TEXT("Worker %d: Processing animation %d/%d: %s"), WorkerIndex, AnimationIdx + 1, AnimationFiles.Num(), *AnimationName);
+
+            // Targets are retargeted in batches that share one source evaluation per frame
+            for (int32 BatchStart = 0; BatchStart < OwnedSkeletons.Num(); BatchStart += FanOut) {
+                TArray<FString> Targets, Outputs;
+                for (int32 i = BatchStart; i < FMath::Min(BatchStart + FanOut, OwnedSkeletons.Num()); ++i) {
+                    const FString SkeletonName = FPaths::GetBaseFilename(OwnedSkeletons[i]);
+                    const FString PrefixedName = SkeletonName + TEXT("__") + AnimationName + TEXT(".fbx");
+                    Targets.Add(OwnedSkeletons[i]);
+                    Outputs.Add(FPaths::Combine(RetargetPath, PrefixedName));
+                }
+                Retargeter.RetargetOneToMany(AnimationFile, Targets, Outputs);
+            }
+            Retargeter.ReleaseSourceCache();
+        }
+        Retargeter.ReleaseTargetCache();
+        return;
+    }
+
     for (int32 SkeletonIdx = WorkerIndex; SkeletonIdx < SkeletonFiles.Num(); SkeletonIdx += NumWorkers) {
         const FString& SkeletonFile = SkeletonFiles[SkeletonIdx];
         const FString SkeletonName = FPaths::GetBaseFilename(SkeletonFile);
@@ -153,36 +501,6 @@ void URetargetWorkerCommandlet::ProcessTestValDirectory(const FString& DirPath,
             const FString OutputFile = FPaths::Combine(RetargetPath, PrefixedName);
             Retargeter.RetargetAPair(AnimationFile, SkeletonFile, OutputFile);
         }
+        Retargeter.ReleaseTargetCache();
     }
 }
-
-TArray<FString> URetargetWorkerCommandlet::GetFBXFiles(const FString& DirectoryPath)
-{
-    TArray<FString> FbxFiles;
-    IFileManager::Get().FindFiles(FbxFiles, *FPaths::Combine(DirectoryPath, TEXT("*.fbx")), true, false);
-    for (FString& File : FbxFiles) {
-        File = FPaths::Combine(DirectoryPath, File);
-    }
-    
-    // Sort files to ensure consistent ordering across runs
-    FbxFiles.Sort();
-    
-    return FbxFiles;
-}
-
-TArray<FString> URetargetWorkerCommandlet::GetRandomSubset(const TArray<FString>& InputArray, int32 Count, int32 Seed)
-{
-    TArray<FString> Result = InputArray;
-    if (Count < InputArray.Num()) {
-        // Initialize random stream with the provided seed
-        FRandomStream RandomStream(Seed);
-        
-        // Perform Fisher-Yates shuffle with seeded random
-        for (int32 i = Result.Num() - 1; i > 0; --i) {
-            const int32 j = RandomStream.RandRange(0, i);
-            Result.Swap(i, j);
-        }
-        Result.SetNum(Count);
-    }
-    return Result;
-}
@@ -18,14 +18,16 @@
 #include "Misc/Paths.h"
 #include "Misc/CommandLine.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/PlatformMemory.h"
 #include "HAL/PlatformTime.h"
-
-#if PLATFORM_UNIX
-#  include <fcntl.h>
-#  include <unistd.h>
-#endif
+#include "Async/ParallelFor.h"
+#include "Tasks/Task.h"
+#include "Interfaces/IPluginManager.h"
 
 namespace {
+// Bump when a change to the retargeting itself should invalidate existing outputs
+constexpr int32 RetargetSettingsVersion = 1;
+
 static FString GetRetargetSessionSuffix()
 {
     FString Suffix;
@@ -35,36 +37,18 @@ static FString GetRetargetSessionSuffix()
     return Suffix;
 }
 
-#if PLATFORM_UNIX
-// Simple lock using atomic create (O_CREAT | O_EXCL). Returns fd in OutFd when acquired.
-bool AcquireFileLock(const FString& LockFile, int MaxWaitMs, int SleepMs, int& OutFd)
+// Each worker session imports into its own package root, so no cross-process lock is needed
+static FString MakeSessionPackageRoot()
 {
-    OutFd = -1;
-    FTCHARToUTF8 PathUtf8(*LockFile);
-    const char* Path = PathUtf8.Get();
-    const double Deadline = FPlatformTime::Seconds() + (MaxWaitMs / 1000.0);
-    while (FPlatformTime::Seconds() < Deadline) {
-        int fd = ::open(Path, O_CREAT | O_EXCL | O_WRONLY, 0644);
-        if (fd != -1) {
-            OutFd = fd;
-            return true;
+    FString Session = GetRetargetSessionSuffix();
+    for (TCHAR& Char : Session) {
+        if (!FChar::IsAlnum(Char) && Char != TEXT('_')) {
+            Char = TEXT('_');
         }
-        FPlatformProcess::Sleep(SleepMs / 1000.0f);
     }
-    return false;
+    return FString::Printf(TEXT("/Game/Animations/tmp/%s"), *Session);
 }
 
-void ReleaseFileLock(const FString& LockFile, int Fd)
-{
-    if (Fd != -1) {
-        ::close(Fd);
-    }
-    IFileManager::Get().Delete(*LockFile, /*RequireExists=*/false, /*EvenReadOnly=*/true);
-}
-#else
-bool AcquireFileLock(const FString&, int, int, int&) { return true; }
-void ReleaseFileLock(const FString&, int) {}
-#endif
 } // namespace
 
 // Asset import includes
@@ -73,15 +57,12 @@ void ReleaseFileLock(const FString&, int) {}
 #include "AssetRegistry/IAssetRegistry.h"
 #include "AssetToolsModule.h"
 #include "AutomatedAssetImportData.h"
-#include "Engine/Level.h"
 #include "Engine/SkeletalMesh.h"
 #include "FileHelpers.h"
 #include "IAssetTools.h"
-#include "ObjectTools.h"
 
 #if WITH_EDITOR
 // IKRig editor/public headers
-#include "AnimPose.h"
 #include "AnimationBlueprintLibrary.h"
 #include "AssetExportTask.h"
 #include "Exporters/AnimSequenceExporterFBX.h"
@@ -99,9 +80,111 @@ void ReleaseFileLock(const FString&, int) {}
 #include "Retargeter/RetargetOps/IKChainsOp.h"
 #include "Retargeter/RetargetOps/RunIKRigOp.h"
 #include "UObject/SavePackage.h"
+#include "UObject/StrongObjectPtr.h"
 #endif
 
 #include "RetargeterLog.h"
+#include "RetargetAllocCounter.h"
+#include "RetargetFbx.h"
+#include "RetargetShard.h"
+#include "RetargetSimd.h"
+#include "RetargetKeyReduction.h"
+#include "RetargetSourcePose.h"
+
+#if WITH_EDITOR
+// Per-chunk state for ProcessFrameChunks. Frames from WarmupFrame to StartFrame only settle the processor.
+struct FRetargetFrameChunk {
+    int32 WarmupFrame = 0;
+    int32 StartFrame = 0;
+    int32 EndFrame = 0;
+    FIKRetargetProcessor Processor;
+    FRetargetProfile Profile;
+    FRetargetSourcePose SourcePose;
+    TArray<FTransform> SourceComponentPose;
+    TArray<FTransform> TargetLocalPose;
+    FRetargetSimdScratch SimdScratch;
+    float SimdError = 0.f;
+};
+
+// A source clip split into chunks. With -validatechunks, Reference retargets the whole clip sequentially.
+struct FRetargetChunkedClip {
+    TSharedPtr<const FRetargetFbxClip> Clip;
+    TArray<TUniquePtr<FRetargetFrameChunk>> Chunks;
+    TUniquePtr<FRetargetFrameChunk> Reference;
+};
+#endif
+
+namespace {
+void AllocateBoneTracks(TArray<FRawAnimSequenceTrack>& BoneTracks, int32 NumBones, int32 NumFrames)
+{
+    BoneTracks.SetNumZeroed(NumBones);
+    for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex) {
+        BoneTracks[BoneIndex].PosKeys.SetNum(NumFrames);
+        BoneTracks[BoneIndex].RotKeys.SetNum(NumFrames);
+        BoneTracks[BoneIndex].ScaleKeys.SetNum(NumFrames);
+    }
+}
+
+#if WITH_EDITOR
+// Per-target state for RetargetOneToMany
+struct FRetargetTargetJob {
+    FString TargetFbx;
+    FString OutputPath;
+    USkeletalMesh* TargetSkeleton = nullptr;
+    UIKRetargeter* IKRetargeter = nullptr;
+    TUniquePtr<FIKRetargetProcessor> Processor;
+    FRetargetProfile Profile;
+    TArray<FTransform> SourcePose;
+    TArray<FTransform> TargetLocalPose;
+    FRetargetSimdScratch SimdScratch;
+    TArray<FRawAnimSequenceTrack> BoneTracks;
+    FRetargetPairMetrics Metrics;
+    double StartTime = 0.0;
+};
+
+// A pair in flight in RetargetPairs. Keeps the assets its output stage needs after the module moves on.
+struct FRetargetPipelinePair {
+    FString InputFbx;
+    FString TargetFbx;
+    FString OutputPath;
+    // Keep the pair's assets alive while the GC policy collects between pairs; tasks never touch them
+    TStrongObjectPtr<UAnimSequence> InputAnimation;
+    TStrongObjectPtr<USkeletalMesh> InputSkeleton;
+    TStrongObjectPtr<USkeletalMesh> TargetSkeleton;
+    TStrongObjectPtr<UIKRigDefinition> InputIKRig;
+    TStrongObjectPtr<UIKRigDefinition> TargetIKRig;
+    TStrongObjectPtr<UIKRetargeter> IKRetargeter;
+    TSharedPtr<const FRetargetFbxClip> InputClip;
+    // Source frames for the tasks; imported animations are baked on the game thread
+    TSharedPtr<const FRetargetFbxClip> TaskClip;
+    FIKRetargetProcessor Processor;
+    FRetargetProfile Profile;
+    FRetargetSourcePose SourcePose;
+    TArray<FTransform> SourceComponentPose;
+    // Used instead of Processor when the clip is chunked
+    FRetargetChunkedClip Chunked;
+    TArray<FRawAnimSequenceTrack> BoneTracks;
+    TArray<FName> TargetBoneNames;
+    FReferenceSkeleton TargetRefSkeleton;
+    FFrameRate FrameRate;
+    int32 NumFrames = 0;
+    FRetargetPairMetrics Metrics;
+    double StartTime = 0.0;
+    bool bWritten = false;
+    UE::Tasks::FTask RetargetTask;
+    UE::Tasks::FTask OutputTask;
+};
+#endif
+
+// Copies into a buffer already sized for the pair, so the frame loop does not reallocate
+void CopyPose(const TArray<FTransform>& From, TArray<FTransform>& To)
+{
+    check(To.Num() == From.Num());
+    for (int32 Index = 0; Index < From.Num(); ++Index) {
+        To[Index] = From[Index];
+    }
+}
+} // namespace
 
 #define LOCTEXT_NAMESPACE "FRetargeterModule"
 
@@ -125,6 +208,129 @@ void FRetargeterModule::SetPersistAssets(bool bInPersist)
 
 bool FRetargeterModule::GetPersistAssets() const { return bPersistAssets; }
 
+void FRetargeterModule::SetDirectFbxExport(bool bInDirect)
+{
+    bDirectFbxExport = bInDirect;
+    UE_LOG(Retargeter, Log, TEXT("DirectFbxExport=%s"), bDirectFbxExport ? TEXT("true") : TEXT("false"));
+}
+
+bool FRetargeterModule::SetShardOutput(const FString& Encoding, int32 MaxShardMB)
+{
+    if (Encoding.IsEmpty()) {
+        CloseShards();
+        ShardSink.Reset();
+        return true;
+    }
+
+    ERetargetShardEncoding ShardEncoding;
+    if (!FRetargetShardSink::ParseEncoding(Encoding, ShardEncoding)) {
+        UE_LOG(Retargeter, Error, TEXT("Unknown shard encoding '%s' (float32, float16, snorm16)"), *Encoding);
+        return false;
+    }
+    CloseShards();
+    ShardSink = MakeShared<FRetargetShardSink>(ShardEncoding, int64(FMath::Max(1, MaxShardMB)) * 1024 * 1024);
+    UE_LOG(Retargeter, Log, TEXT("ShardOutput=%s, %d MB per shard"), *Encoding, MaxShardMB);
+    return true;
+}
+
+bool FRetargeterModule::UsesShardOutput() const { return ShardSink.IsValid(); }
+
+void FRetargeterModule::CloseShards()
+{
+    if (ShardSink) {
+        ShardSink->Close();
+    }
+}
+
+void FRetargeterModule::SetCountAllocations(bool bInCount)
+{
+    bCountAllocs = bInCount;
+    if (bCountAllocs) {
+        FRetargetAllocCounter::Install();
+    }
+}
+
+bool FRetargeterModule::ConsumeFrameAllocations(uint64& OutTotal, uint64& OutMax, int32& OutNumFrames)
+{
+    OutTotal = FrameAllocsTotal;
+    OutMax = FrameAllocsMax;
+    OutNumFrames = NumFramesCounted;
+    FrameAllocsTotal = 0;
+    FrameAllocsMax = 0;
+    NumFramesCounted = 0;
+    return bCountAllocs;
+}
+
+void FRetargeterModule::SetReduceKeys(bool bInReduce)
+{
+    bReduceKeys = bInReduce;
+    UE_LOG(Retargeter, Log, TEXT("ReduceKeys=%s"), bReduceKeys ? TEXT("true") : TEXT("false"));
+}
+
+void FRetargeterModule::SetSkipCompression(bool bInSkip)
+{
+    bSkipCompression = bInSkip;
+    UE_LOG(Retargeter, Log, TEXT("SkipCompression=%s"), bSkipCompression ? TEXT("true") : TEXT("false"));
+}
+
+void FRetargeterModule::SetFrameChunking(int32 ChunkFrames, int32 WarmupFrames)
+{
+    FrameChunkFrames = FMath::Max(0, ChunkFrames);
+    FrameChunkWarmup = FMath::Max(0, WarmupFrames);
+    UE_LOG(Retargeter, Log, TEXT("FrameChunking=%d frames, %d warm-up"), FrameChunkFrames, FrameChunkWarmup);
+}
+
+void FRetargeterModule::SetValidateSimd(bool bInValidate) { bValidateSimd = bInValidate; }
+
+void FRetargeterModule::SetValidateChunks(bool bInValidate) { bValidateChunks = bInValidate; }
+
+void FRetargeterModule::SetScalarLocal(bool bInScalar) { bScalarLocal = bInScalar; }
+
+bool FRetargeterModule::SetMetricsOutput(const FString& Run)
+{
+    if (Run.IsEmpty()) {
+        MetricsWriter.Reset();
+        return true;
+    }
+
+    const FString File = RetargetMetrics::GetMetricsFile(Run, GetRetargetSessionSuffix());
+    MetricsWriter = MakeShared<FRetargetMetricsWriter>();
+    if (!MetricsWriter->Open(File)) {
+        UE_LOG(Retargeter, Error, TEXT("Failed to open metrics file %s"), *File);
+        MetricsWriter.Reset();
+        return false;
+    }
+    UE_LOG(Retargeter, Log, TEXT("Writing pair metrics to %s"), *File);
+    return true;
+}
+
+void FRetargeterModule::SetGCPolicy(int32 RssMB, int32 Objects, int32 EveryPairs)
+{
+    GCPolicy.SetThresholds(RssMB, Objects, EveryPairs);
+}
+
+FRetargetGCStats FRetargeterModule::ConsumeGCStats() { return GCPolicy.ConsumeStats(); }
+
+bool FRetargeterModule::ConsumeSimdError(float& OutMaxError)
+{
+    OutMaxError = SimdMaxError;
+    SimdMaxError = 0.f;
+    return bValidateSimd;
+}
+
+bool FRetargeterModule::ConsumeChunkError(float& OutMaxError)
+{
+    OutMaxError = ChunkMaxError;
+    ChunkMaxError = 0.f;
+    return bValidateChunks;
+}
+
+void FRetargeterModule::SetDirectFbxImport(bool bInDirect)
+{
+    bDirectFbxImport = bInDirect;
+    UE_LOG(Retargeter, Log, TEXT("DirectFbxImport=%s"), bDirectFbxImport ? TEXT("true") : TEXT("false"));
+}
+
 void FRetargeterModule::StartupModule()
 {
     SingletonInstance = this;
@@ -142,36 +348,42 @@ void FRetargeterModule::StartupModule()
 #endif
 }
 
-void FRetargeterModule::RetargetWithRTG()
+bool FRetargeterModule::RetargetWithRTG(const FString& OutputPath)
 {
     // Validate inputs
-    if (!InputAnimation || !InputSkeleton || !TargetSkeleton || !IKRetargeter) {
+    if (!HasSourceAnimation() || !InputSkeleton || !TargetSkeleton || !IKRetargeter) {
         UE_LOG(Retargeter, Warning, TEXT("retargetWithRTG: missing input(s). Anim=%p InMesh=%p TgtMesh=%p RTG=%p"),
             InputAnimation, InputSkeleton, TargetSkeleton, IKRetargeter);
-        return;
+        return false;
     }
 
 #if WITH_EDITOR
+    // Long clips are retargeted in chunks, each with its own processor
+    const int32 NumFrames = GetSourceNumFrames();
+    if (UsesFrameChunks(NumFrames)) {
+        FRetargetChunkedClip Chunked;
+        TArray<FRawAnimSequenceTrack> BoneTracks;
+        {
+            FRetargetStageScope Scope(PairMetrics, ERetargetStage::Retarget);
+            if (!InitializeFrameChunks(GetTaskSafeSourceClip(), Chunked)) {
+                return false;
+            }
+            ProcessFrameChunks(Chunked, BoneTracks);
+        }
+        const TArray<FName>& TargetBoneNames
+            = Chunked.Chunks[0]->Processor.GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames;
+        PairMetrics.NumFrames = NumFrames;
+        PairMetrics.NumBones = TargetBoneNames.Num();
+        return WriteOutput(OutputPath, BoneTracks, TargetBoneNames);
+    }
+
     // Initialize processor with chain retargeting profile from asset
     FIKRetargetProcessor Processor;
     FRetargetProfile RetargetProfile;
     if (!InitializeRetargetProcessor(Processor, RetargetProfile)) {
-        return;
-    }
-
-    // Create output sequence
-    const FString OutName = FString::Printf(TEXT("%s_RTG"), *InputAnimation->GetName());
-    UAnimSequence* TargetSequence = CreateTargetSequence(OutName);
-    if (!TargetSequence) {
-        UE_LOG(Retargeter, Error, TEXT("retargetWithRTG: Failed to create output UAnimSequence"));
-        return;
+        return false;
     }
 
-    // Setup animation controller and get frame count
-    IAnimationDataController& Ctrl = TargetSequence->GetController();
-    int32 NumFrames = 0;
-    SetupAnimationController(TargetSequence, Ctrl, NumFrames);
-
     // Gather skeleton info
     const FRetargetSkeleton& TargetRig = Processor.GetSkeleton(ERetargetSourceOrTarget::Target);
     const TArray<FName>& TargetBoneNames = TargetRig.BoneNames;
@@ -180,6 +392,8 @@ void FRetargeterModule::RetargetWithRTG()
     const FRetargetSkeleton& SourceRig = Processor.GetSkeleton(ERetargetSourceOrTarget::Source);
     const TArray<FName>& SourceBoneNames = SourceRig.BoneNames;
     const int32 NumSourceBones = SourceBoneNames.Num();
+    PairMetrics.NumFrames = NumFrames;
+    PairMetrics.NumBones = NumTargetBones;
 
     // Allocate source pose buffer
     TArray<FTransform> SourceComponentPose;
@@ -187,39 +401,104 @@ void FRetargeterModule::RetargetWithRTG()
 
     // Pre-allocate bone tracks
     TArray<FRawAnimSequenceTrack> BoneTracks;
-    BoneTracks.SetNumZeroed(NumTargetBones);
-    for (int32 BoneIndex = 0; BoneIndex < NumTargetBones; ++BoneIndex) {
-        BoneTracks[BoneIndex].PosKeys.SetNum(NumFrames);
-        BoneTracks[BoneIndex].RotKeys.SetNum(NumFrames);
-        BoneTracks[BoneIndex].ScaleKeys.SetNum(NumFrames);
-    }
+    AllocateBoneTracks(BoneTracks, NumTargetBones, NumFrames);
 
-    // Evaluate options to match editor behavior
-    FAnimPoseEvaluationOptions EvalOptions;
-    EvalOptions.OptionalSkeletalMesh = const_cast<USkeletalMesh*>(SourceRig.SkeletalMesh);
-    EvalOptions.bExtractRootMotion = false;
-    EvalOptions.bIncorporateRootMotionIntoPose = true;
+    // Source bone remap, built once for the pair
+    FRetargetSourcePose SourcePose;
+    if (!SourcePose.Initialize(InputAnimation, InputClip, SourceRig)) {
+        return false;
+    }
 
     // Process frame retargeting
-    ProcessFrameRetargeting(Processor, SourceRig, TargetRig, SourceBoneNames, TargetBoneNames, SourceComponentPose,
-        BoneTracks, EvalOptions, NumFrames, NumTargetBones);
+    {
+        FRetargetStageScope Scope(PairMetrics, ERetargetStage::Retarget);
+        ProcessFrameRetargeting(Processor, RetargetProfile, TargetRig, SourceComponentPose, BoneTracks, SourcePose,
+            NumFrames, NumTargetBones);
+    }
 
-    // Commit bone tracks to animation
-    CommitBoneTracks(Ctrl, BoneTracks, TargetBoneNames, NumTargetBones);
+    return WriteOutput(OutputPath, BoneTracks, TargetBoneNames);
+#else
+    UE_LOG(Retargeter, Warning, TEXT("retargetWithRTG: Editor-only retargeting is not available in this build"));
+    return false;
+#endif
+}
+
+bool FRetargeterModule::WriteOutput(const FString& OutputPath, const TArray<FRawAnimSequenceTrack>& BoneTracks,
+    const TArray<FName>& TargetBoneNames)
+{
+    if (ShardSink || bDirectFbxExport) {
+        return WriteTracksToFile(OutputPath, FPaths::GetBaseFilename(CurrentInputFbx),
+            FPaths::GetBaseFilename(CurrentTargetFbx), TargetSkeleton->GetRefSkeleton(), BoneTracks,
+            GetSourceFrameRate(), PairMetrics);
+    }
+
+    // Build the output sequence from the retargeted tracks
+    if (!BuildOutputSequence(BoneTracks, TargetBoneNames)) {
+        return false;
+    }
+    FRetargetStageScope Scope(PairMetrics, ERetargetStage::Export);
+    if (!ExportOutputAnimationFBX(OutputPath)) {
+        return false;
+    }
+    PairMetrics.BytesWritten = FMath::Max<int64>(0, IFileManager::Get().FileSize(*OutputPath));
+    return true;
+}
+
+bool FRetargeterModule::WriteTracksToFile(const FString& OutputPath, const FString& InputName,
+    const FString& TargetName, const FReferenceSkeleton& RefSkeleton, const TArray<FRawAnimSequenceTrack>& BoneTracks,
+    const FFrameRate& FrameRate, FRetargetPairMetrics& Metrics)
+{
+    FRetargetStageScope Scope(Metrics, ERetargetStage::Export);
+    if (ShardSink) {
+        return ShardSink->AddClip(OutputPath, TargetName, RefSkeleton, InputName, BoneTracks, FrameRate);
+    }
+
+    // Tracks are in target rig order, which follows the target reference skeleton
+    const FRetargetKeyReductionSettings Reduction;
+    const bool bOk = RetargetFbx::WriteFbx(
+        OutputPath, RefSkeleton, BoneTracks, FrameRate, bReduceKeys ? &Reduction : nullptr, &Metrics.KeyRatio);
+    UE_LOG(Retargeter, Log, TEXT("Write FBX %s: %s"), bOk ? TEXT("succeeded") : TEXT("failed"), *OutputPath);
+    Metrics.BytesWritten = FMath::Max<int64>(0, IFileManager::Get().FileSize(*OutputPath));
+    return bOk;
+}
+
+bool FRetargeterModule::BuildOutputSequence(
+    const TArray<FRawAnimSequenceTrack>& BoneTracks, const TArray<FName>& TargetBoneNames)
+{
+    // Create output sequence
+    const FString SourceName = InputAnimation ? InputAnimation->GetName() : FPaths::GetBaseFilename(CurrentInputFbx);
+    const FString OutName = FString::Printf(TEXT("%s_RTG"), *SourceName);
+    UAnimSequence* TargetSequence = CreateTargetSequence(OutName);
+    if (!TargetSequence) {
+        UE_LOG(Retargeter, Error, TEXT("retargetWithRTG: Failed to create output UAnimSequence"));
+        return false;
+    }
 
-    Ctrl.CloseBracket(false);
+    // Setup animation controller and get frame count
+    IAnimationDataController& Ctrl = TargetSequence->GetController();
+    int32 NumFrames = 0;
+    SetupAnimationController(TargetSequence, Ctrl, NumFrames);
+
+    // Commit bone tracks to animation
+    {
+        FRetargetStageScope Scope(PairMetrics, ERetargetStage::Commit);
+        CommitBoneTracks(Ctrl, BoneTracks, TargetBoneNames, TargetBoneNames.Num());
+        Ctrl.CloseBracket(false);
+    }
 
-    // Finalize the target sequence
+    // Finalize the target sequence. Timed so runs with and without -nocompress can be compared.
+    const double FinalizeStart = FPlatformTime::Seconds();
     FinalizeTargetSequence(TargetSequence);
+    const double FinalizeSeconds = FPlatformTime::Seconds() - FinalizeStart;
+    PairMetrics[ERetargetStage::Finalize] += FinalizeSeconds;
+    UE_LOG(Retargeter, Log, TEXT("retargetWithRTG: finalize took %.1f ms (compression %s)"), FinalizeSeconds * 1000.0,
+        (bSkipCompression && !bPersistAssets) ? TEXT("skipped") : TEXT("on"));
 
-    // Create output copy
-    CreateOutputCopy(TargetSequence);
+    outputAnimation = TargetSequence;
 
     UE_LOG(Retargeter, Log, TEXT("retargetWithRTG: Completed retargeting to output sequence %s"),
         *TargetSequence->GetName());
-#else
-    UE_LOG(Retargeter, Warning, TEXT("retargetWithRTG: Editor-only retargeting is not available in this build"));
-#endif
+    return true;
 }
 
 bool FRetargeterModule::InitializeRetargetProcessor(FIKRetargetProcessor& Processor, FRetargetProfile& RetargetProfile)
@@ -236,39 +515,26 @@ bool FRetargeterModule::InitializeRetargetProcessor(FIKRetargetProcessor& Proces
 
 UAnimSequence* FRetargeterModule::CreateTargetSequence(const FString& OutputName)
 {
+    // Empty sequence bound to the target skeleton; the controller fills in frame rate, length and tracks
     UAnimSequence* TargetSequence = nullptr;
-
-    if (bPersistAssets && InputAnimation->GetOutermost()) {
-        // Duplicate into /Game/Animations/tmp
-        const FString DesiredPath = TEXT("/Game/Animations/tmp");
+    if (bPersistAssets) {
         FString UniquePkgName, UniqueAssetName;
         const FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
         AssetToolsModule.Get().CreateUniqueAssetName(
-            DesiredPath / OutputName, TEXT(""), UniquePkgName, UniqueAssetName);
+            GetSessionPackageRoot() / OutputName, TEXT(""), UniquePkgName, UniqueAssetName);
 
         UPackage* Package = CreatePackage(*UniquePkgName);
-        TargetSequence = DuplicateObject<UAnimSequence>(InputAnimation, Package, *UniqueAssetName);
-        if (TargetSequence) {
-            //! prevent controller close bracket deadlock
-            // Wait for any existing compression to finish, without acquiring the readlock
-            // So that the controller can acquire the writelock in closebracket
-            TargetSequence->WaitOnExistingCompression(true);
-            TargetSequence->SetFlags(RF_Public | RF_Standalone);
-            TargetSequence->SetSkeleton(TargetSkeleton->GetSkeleton());
-            TargetSequence->SetPreviewMesh(TargetSkeleton);
-            TargetSequence->MarkPackageDirty();
-        }
+        TargetSequence = NewObject<UAnimSequence>(Package, *UniqueAssetName, RF_Public | RF_Standalone);
+        TargetSequence->MarkPackageDirty();
     } else {
-        // Transient duplicate
         FName UniqueName = MakeUniqueObjectName(GetTransientPackage(), UAnimSequence::StaticClass(), *OutputName);
-        TargetSequence = DuplicateObject<UAnimSequence>(InputAnimation, GetTransientPackage(), UniqueName);
-        if (TargetSequence) {
-            TargetSequence->WaitOnExistingCompression(true);
-            TargetSequence->SetSkeleton(TargetSkeleton->GetSkeleton());
-            TargetSequence->SetPreviewMesh(TargetSkeleton);
-        }
+        TargetSequence = NewObject<UAnimSequence>(GetTransientPackage(), UniqueName);
     }
 
+    TargetSequence->SetSkeleton(TargetSkeleton->GetSkeleton());
+    TargetSequence->SetPreviewMesh(TargetSkeleton);
+    TargetSequence->GetController().InitializeModel();
+    PairCreatedObjects.Add(TargetSequence);
     return TargetSequence;
 }
 
@@ -281,91 +547,206 @@ void FRetargeterModule::SetupAnimationController(
     Ctrl.OpenBracket(FText::FromString("Generating Retargeted Animation Data"), bTransact);
     Ctrl.NotifyPopulated();
 
-    // For duplicated sequences, the model is already initialized; still ensure frame rate and length are consistent
-    const IAnimationDataModel* SrcModel = InputAnimation->GetDataModel();
-    const FFrameRate SrcFrameRate = SrcModel->GetFrameRate();
-    Ctrl.SetFrameRate(SrcFrameRate, bTransact);
-    NumFrames = SrcModel->GetNumberOfFrames();
+    // Frame rate and length come from the source
+    Ctrl.SetFrameRate(GetSourceFrameRate(), bTransact);
+    NumFrames = GetSourceNumFrames();
     Ctrl.SetNumberOfFrames(NumFrames, bTransact);
 }
 
-void FRetargeterModule::ProcessFrameRetargeting(FIKRetargetProcessor& Processor, const FRetargetSkeleton& SourceRig,
-    const FRetargetSkeleton& TargetRig, const TArray<FName>& SourceBoneNames, const TArray<FName>& TargetBoneNames,
+void FRetargeterModule::ProcessFrameRetargeting(FIKRetargetProcessor& Processor,
+    const FRetargetProfile& SettingsProfile, const FRetargetSkeleton& TargetRig,
     TArray<FTransform>& SourceComponentPose, TArray<FRawAnimSequenceTrack>& BoneTracks,
-    const FAnimPoseEvaluationOptions& EvalOptions, int32 NumFrames, int32 NumTargetBones)
+    FRetargetSourcePose& SourcePose, int32 NumFrames, int32 NumTargetBones)
 {
-    const int32 NumSourceBones = SourceBoneNames.Num();
-
     // Reset playback of ops
     Processor.OnPlaybackReset();
 
-    // Iterate frames and retarget
+    // Iterate frames and retarget. Scratch buffers are sized once for the pair.
+    TArray<FTransform> TargetLocalPose;
+    TargetLocalPose.SetNum(NumTargetBones);
+    FRetargetSimdScratch SimdScratch;
+    SimdScratch.SetNum(NumTargetBones);
     for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex) {
-        // Source pose at this frame
-        FAnimPose SourcePose;
-        UAnimPoseExtensions::GetAnimPoseAtFrame(InputAnimation, FrameIndex, EvalOptions, SourcePose);
-
-        for (int32 SIndex = 0; SIndex < NumSourceBones; ++SIndex) {
-            const FName& BoneName = SourceBoneNames[SIndex];
-            SourceComponentPose[SIndex]
-                = UAnimPoseExtensions::GetBonePose(SourcePose, BoneName, EAnimPoseSpaces::World);
+        const uint64 AllocsBefore = FRetargetAllocCounter::GetThreadAllocs();
+        EvaluateSourceFrame(FrameIndex, SourcePose, SourceComponentPose);
+
+        // Allow processor to scale if needed
+        Processor.ScaleSourcePose(SourceComponentPose);
+
+        const float SimdError = RetargetFrame(Processor, TargetRig, SettingsProfile, SourceComponentPose,
+            SourcePose.GetDeltaTime(FrameIndex), FrameIndex, TargetLocalPose, SimdScratch, BoneTracks);
+        SimdMaxError = FMath::Max(SimdMaxError, SimdError);
+        RecordFrameAllocations(AllocsBefore);
+    }
+}
+
+TSharedPtr<const FRetargetFbxClip> FRetargeterModule::GetTaskSafeSourceClip()
+{
+    if (InputClip) {
+        return InputClip;
+    }
+    // Animation evaluation reads UObjects, so imported sources are evaluated here into a plain buffer
+    return FRetargetSourcePose::BakeClip(InputAnimation, InputSkeleton);
+}
+
+bool FRetargeterModule::InitializeFrameChunks(TSharedPtr<const FRetargetFbxClip> Clip, FRetargetChunkedClip& OutChunked)
+{
+    if (!Clip) {
+        return false;
+    }
+
+    // Processors touch UObjects while initializing, so they are all set up here on the game thread
+    auto AddChunk = [this, &Clip](int32 WarmupFrame, int32 StartFrame, int32 EndFrame) {
+        TUniquePtr<FRetargetFrameChunk> Chunk = MakeUnique<FRetargetFrameChunk>();
+        Chunk->WarmupFrame = WarmupFrame;
+        Chunk->StartFrame = StartFrame;
+        Chunk->EndFrame = EndFrame;
+        if (!InitializeRetargetProcessor(Chunk->Processor, Chunk->Profile)) {
+            return TUniquePtr<FRetargetFrameChunk>();
         }
-        for (FTransform& Xform : SourceComponentPose) {
-            Xform.SetScale3D(FVector::OneVector);
+        const FRetargetSkeleton& SourceRig = Chunk->Processor.GetSkeleton(ERetargetSourceOrTarget::Source);
+        if (!Chunk->SourcePose.Initialize(nullptr, Clip, SourceRig)) {
+            return TUniquePtr<FRetargetFrameChunk>();
         }
+        const int32 NumTargetBones = Chunk->Processor.GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames.Num();
+        Chunk->SourceComponentPose.SetNum(SourceRig.BoneNames.Num());
+        Chunk->TargetLocalPose.SetNum(NumTargetBones);
+        Chunk->SimdScratch.SetNum(NumTargetBones);
+        Chunk->Processor.OnPlaybackReset();
+        return Chunk;
+    };
 
-        const float TimeAtFrame = InputAnimation->GetTimeAtFrame(FrameIndex);
-        float DeltaTime = (FrameIndex > 0) ? TimeAtFrame - InputAnimation->GetTimeAtFrame(FrameIndex - 1) : TimeAtFrame;
+    OutChunked.Clip = Clip;
+    const int32 NumFrames = Clip->NumFrames;
+    for (int32 StartFrame = 0; StartFrame < NumFrames; StartFrame += FrameChunkFrames) {
+        TUniquePtr<FRetargetFrameChunk> Chunk = AddChunk(FMath::Max(0, StartFrame - FrameChunkWarmup), StartFrame,
+            FMath::Min(StartFrame + FrameChunkFrames, NumFrames));
+        if (!Chunk) {
+            return false;
+        }
+        OutChunked.Chunks.Add(MoveTemp(Chunk));
+    }
+    if (bValidateChunks) {
+        OutChunked.Reference = AddChunk(0, 0, NumFrames);
+        if (!OutChunked.Reference) {
+            return false;
+        }
+    }
+    return OutChunked.Chunks.Num() > 0;
+}
 
-        // Settings profile per frame
-        FRetargetProfile SettingsProfile;
-        SettingsProfile.FillProfileWithAssetSettings(IKRetargeter);
+void FRetargeterModule::ProcessFrameChunks(FRetargetChunkedClip& Chunked, TArray<FRawAnimSequenceTrack>& BoneTracks)
+{
+    const int32 NumFrames = Chunked.Clip->NumFrames;
+    const int32 NumTargetBones
+        = Chunked.Chunks[0]->Processor.GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames.Num();
+    AllocateBoneTracks(BoneTracks, NumTargetBones, NumFrames);
+
+    // Chunks only read the shared clip, so they need no UObjects
+    auto RunChunk = [this](FRetargetFrameChunk& Chunk, TArray<FRawAnimSequenceTrack>& OutTracks) {
+        const FRetargetSkeleton& TargetRig = Chunk.Processor.GetSkeleton(ERetargetSourceOrTarget::Target);
+        for (int32 FrameIndex = Chunk.WarmupFrame; FrameIndex < Chunk.EndFrame; ++FrameIndex) {
+            EvaluateSourceFrame(FrameIndex, Chunk.SourcePose, Chunk.SourceComponentPose);
+            Chunk.Processor.ScaleSourcePose(Chunk.SourceComponentPose);
+            const float DeltaTime = Chunk.SourcePose.GetDeltaTime(FrameIndex);
+            // Warm-up frames belong to the previous chunk; they are retargeted but their keys are not written
+            if (FrameIndex < Chunk.StartFrame) {
+                Chunk.Processor.RunRetargeter(Chunk.SourceComponentPose, Chunk.Profile, DeltaTime);
+                continue;
+            }
+            const float SimdError = RetargetFrame(Chunk.Processor, TargetRig, Chunk.Profile, Chunk.SourceComponentPose,
+                DeltaTime, FrameIndex, Chunk.TargetLocalPose, Chunk.SimdScratch, OutTracks);
+            Chunk.SimdError = FMath::Max(Chunk.SimdError, SimdError);
+        }
+    };
 
-        // Allow processor to scale if needed
-        Processor.ScaleSourcePose(SourceComponentPose);
+    ParallelFor(Chunked.Chunks.Num(),
+        [&Chunked, &BoneTracks, &RunChunk](int32 ChunkIndex) { RunChunk(*Chunked.Chunks[ChunkIndex], BoneTracks); });
+    for (const TUniquePtr<FRetargetFrameChunk>& Chunk : Chunked.Chunks) {
+        SimdMaxError = FMath::Max(SimdMaxError, Chunk->SimdError);
+    }
 
-        // Run retargeter (chain retargeting)
-        const TArray<FTransform>& TargetComponentPose
-            = Processor.RunRetargeter(SourceComponentPose, SettingsProfile, DeltaTime);
-
-        // Convert to local
-        TArray<FTransform> TargetLocalPose = TargetComponentPose;
-        TargetRig.UpdateLocalTransformsBelowBone(0, TargetLocalPose, TargetComponentPose);
-
-        // Write keys for each bone
-        for (int32 TBoneIndex = 0; TBoneIndex < NumTargetBones; ++TBoneIndex) {
-            const FTransform& Local = TargetLocalPose[TBoneIndex];
-            FRawAnimSequenceTrack& Track = BoneTracks[TBoneIndex];
-            Track.PosKeys[FrameIndex] = FVector3f(Local.GetLocation());
-            Track.RotKeys[FrameIndex] = FQuat4f(Local.GetRotation().GetNormalized());
-            Track.ScaleKeys[FrameIndex] = FVector3f(Local.GetScale3D());
+    // Warm-up only approximates the playback state at each seam; compare with one sequential pass
+    if (Chunked.Reference) {
+        TArray<FRawAnimSequenceTrack> ReferenceTracks;
+        AllocateBoneTracks(ReferenceTracks, NumTargetBones, NumFrames);
+        RunChunk(*Chunked.Reference, ReferenceTracks);
+        ChunkMaxError = FMath::Max(ChunkMaxError, RetargetSimd::MaxTrackError(BoneTracks, ReferenceTracks));
+    }
+}
+
+void FRetargeterModule::RecordFrameAllocations(uint64 AllocsBefore)
+{
+    if (!bCountAllocs) {
+        return;
+    }
+    const uint64 Allocs = FRetargetAllocCounter::GetThreadAllocs() - AllocsBefore;
+    FrameAllocsTotal += Allocs;
+    FrameAllocsMax = FMath::Max(FrameAllocsMax, Allocs);
+    ++NumFramesCounted;
+}
+
+void FRetargeterModule::EvaluateSourceFrame(
+    int32 FrameIndex, FRetargetSourcePose& SourcePose, TArray<FTransform>& OutSourceComponentPose)
+{
+    SourcePose.Evaluate(FrameIndex, OutSourceComponentPose);
+    for (FTransform& Xform : OutSourceComponentPose) {
+        Xform.SetScale3D(FVector::OneVector);
+    }
+}
+
+float FRetargeterModule::RetargetFrame(FIKRetargetProcessor& Processor, const FRetargetSkeleton& TargetRig,
+    const FRetargetProfile& SettingsProfile, TArray<FTransform>& SourceComponentPose, float DeltaTime,
+    int32 FrameIndex, TArray<FTransform>& TargetLocalPose, FRetargetSimdScratch& SimdScratch,
+    TArray<FRawAnimSequenceTrack>& BoneTracks)
+{
+    // Run retargeter (chain retargeting)
+    const TArray<FTransform>& TargetComponentPose
+        = Processor.RunRetargeter(SourceComponentPose, SettingsProfile, DeltaTime);
+
+    // Convert to local and write keys for each bone. Poses the SIMD kernel does not cover take the scalar path.
+    const bool bSimd
+        = !bScalarLocal && RetargetSimd::ComponentToLocal(TargetComponentPose, TargetRig.ParentIndices, SimdScratch);
+    if (bSimd) {
+        RetargetSimd::WriteKeys(SimdScratch, FrameIndex, BoneTracks);
+        if (!bValidateSimd) {
+            return 0.f;
         }
     }
+
+    // Scalar path, also the reference for -validatesimd
+    CopyPose(TargetComponentPose, TargetLocalPose);
+    TargetRig.UpdateLocalTransformsBelowBone(0, TargetLocalPose, TargetComponentPose);
+    if (!bSimd) {
+        RetargetSimd::WriteLocalKeys(TargetLocalPose, FrameIndex, BoneTracks);
+        return 0.f;
+    }
+    return RetargetSimd::MaxKeyError(BoneTracks, FrameIndex, TargetLocalPose);
 }
 
 void FRetargeterModule::CommitBoneTracks(IAnimationDataController& Ctrl,
     const TArray<FRawAnimSequenceTrack>& BoneTracks, const TArray<FName>& TargetBoneNames, int32 NumTargetBones)
 {
+    // The sequence starts empty, so every bone gets a new track
     constexpr bool bTransact = false;
-    TArray<FName> TrackNames;
-    Ctrl.GetModel()->GetBoneTrackNames(TrackNames);
-    TSet<FName> TrackSet(TrackNames);
     for (int32 TBoneIndex = 0; TBoneIndex < NumTargetBones; ++TBoneIndex) {
         const FName& BoneName = TargetBoneNames[TBoneIndex];
         const FRawAnimSequenceTrack& Raw = BoneTracks[TBoneIndex];
-        if (!TrackSet.Contains(BoneName)) {
-            Ctrl.AddBoneCurve(BoneName, bTransact);
-        }
+        Ctrl.AddBoneCurve(BoneName, bTransact);
         Ctrl.SetBoneTrackKeys(BoneName, Raw.PosKeys, Raw.RotKeys, Raw.ScaleKeys, bTransact);
     }
 }
 
 void FRetargeterModule::FinalizeTargetSequence(UAnimSequence* TargetSequence)
 {
-    // Mark and save if requested
-    TargetSequence->PostEditChange();
+    // PostEditChange compresses the sequence. Transient outputs are only exported from their raw data model
+    // and then collected, so compression can be skipped for them; persisted outputs always get it.
+    if (!bSkipCompression || bPersistAssets) {
+        TargetSequence->PostEditChange();
+    }
     TargetSequence->MarkPackageDirty();
 
+    // Save if requested
     if (bPersistAssets) {
         if (UPackage* Pkg = TargetSequence->GetOutermost()) {
             FSavePackageArgs SaveArgs;
@@ -379,24 +760,6 @@ void FRetargeterModule::FinalizeTargetSequence(UAnimSequence* TargetSequence)
     }
 }
 
-void FRetargeterModule::CreateOutputCopy(UAnimSequence* TargetSequence)
-{
-    // Always create a transient copy and store in outputAnimation
-    const FString CopyBaseName = FString::Printf(TEXT("%s_OutputCopy"), *TargetSequence->GetName());
-    const FName CopyName
-        = MakeUniqueObjectName(GetTransientPackage(), UAnimSequence::StaticClass(), FName(*CopyBaseName));
-    UAnimSequence* CopySeq = DuplicateObject<UAnimSequence>(TargetSequence, GetTransientPackage(), CopyName);
-    if (CopySeq) {
-        CopySeq->WaitOnExistingCompression(true);
-        CopySeq->SetSkeleton(TargetSkeleton->GetSkeleton());
-        CopySeq->SetPreviewMesh(TargetSkeleton);
-        outputAnimation = CopySeq;
-    } else {
-        // Fallback to original if duplication failed
-        outputAnimation = TargetSequence;
-    }
-}
-
 void FRetargeterModule::ShutdownModule()
 {
 #if WITH_EDITOR
@@ -442,102 +805,59 @@ void FRetargeterModule::PluginButtonClicked()
 }
 #endif // WITH_EDITOR
 
-void FRetargeterModule::ClearAssetsInPath(const FString& Path)
-{
-    FAssetRegistryModule& AssetRegistryModule
-        = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    TArray<FAssetData> AssetsToDelete;
-    AssetRegistryModule.Get().ScanPathsSynchronous({ Path }, /*bForceRescan*/ true);
-    AssetRegistryModule.Get().GetAssetsByPath(FName(*Path), AssetsToDelete, true);
-    if (AssetsToDelete.Num() > 0) {
-        UE_LOG(Retargeter, Log, TEXT("Deleting %d assets under %s (non-interactive)"), AssetsToDelete.Num(), *Path);
-        const int32 NumDeleted = ObjectTools::DeleteAssets(AssetsToDelete, /*bShowConfirmation=*/false);
-        UE_LOG(Retargeter, Log, TEXT("DeleteAssets removed %d assets from %s"), NumDeleted, *Path);
-
-        // Fallback: some assets may remain (e.g., references prevent standard delete). Try force delete in commandlets.
-        AssetsToDelete.Reset();
-        AssetRegistryModule.Get().ScanPathsSynchronous({ Path }, /*bForceRescan*/ true);
-        AssetRegistryModule.Get().GetAssetsByPath(FName(*Path), AssetsToDelete, true);
-        if (AssetsToDelete.Num() > 0 && IsRunningCommandlet()) {
-            TArray<UObject*> ObjectsToForceDelete;
-            ObjectsToForceDelete.Reserve(AssetsToDelete.Num());
-            for (const FAssetData& AssetData : AssetsToDelete) {
-                if (UObject* Obj = AssetData.GetAsset({ ULevel::LoadAllExternalObjectsTag })) {
-                    ObjectsToForceDelete.Add(Obj);
-                }
-            }
-            if (ObjectsToForceDelete.Num() > 0) {
-                UE_LOG(Retargeter, Log, TEXT("Force deleting %d remaining assets under %s"), ObjectsToForceDelete.Num(),
-                    *Path);
-                const int32 NumForceDeleted
-                    = ObjectTools::ForceDeleteObjects(ObjectsToForceDelete, /*ShowConfirmation=*/false);
-                UE_LOG(Retargeter, Log, TEXT("ForceDeleteObjects removed %d assets from %s"), NumForceDeleted, *Path);
-            }
+int32 FRetargeterModule::DeleteCreatedObjects(TArray<TWeakObjectPtr<UObject>>& Objects)
+{
+    // Releases exactly the objects this module created; no asset registry scans. Memory is reclaimed by the
+    // GC policy, so nothing here collects garbage.
+    const double StartTime = FPlatformTime::Seconds();
+    TSet<UPackage*> Packages;
+    int32 NumReleased = 0;
+    for (const TWeakObjectPtr<UObject>& Weak : Objects) {
+        UObject* Obj = Weak.Get();
+        if (!Obj) {
+            continue;
         }
+        Obj->RemoveFromRoot();
+        if (Obj->GetOutermost() == GetTransientPackage()) {
+            // Transient standalone objects would otherwise never be collected
+            Obj->ClearFlags(RF_Standalone);
+            NumReleased++;
+        } else {
+            // Garbage references are cleared by the next collection, which a standard delete would force now
+            Packages.Add(Obj->GetOutermost());
+            FAssetRegistryModule::AssetDeleted(Obj);
+            Obj->ClearFlags(RF_Standalone | RF_Public);
+            Obj->MarkAsGarbage();
+            NumReleased++;
+        }
+    }
+    Objects.Reset();
+
+    // Saved packages are removed from disk here since no delete operation does it
+    for (UPackage* Package : Packages) {
+        FString Filename;
+        if (FPackageName::DoesPackageExist(Package->GetName(), &Filename)
+            && !IFileManager::Get().Delete(*Filename, false, true, true)) {
+            UE_LOG(Retargeter, Warning, TEXT("DeleteCreatedObjects: could not delete %s"), *Filename);
+        }
+        Package->ClearDirtyFlag();
+        Package->MarkAsGarbage();
     }
+
+    PairMetrics[ERetargetStage::Cleanup] += FPlatformTime::Seconds() - StartTime;
+    return NumReleased;
 }
 
 void FRetargeterModule::CleanPreviousOutputs()
 {
-    // Clean previously generated transient/persistent outputs under our temp folder.
-    // Keep input/target subfolders intact; only clear assets directly under /Game/Animations/tmp.
-    const FString RootOutputPath = TEXT("/Game/Animations/tmp");
-
-    FAssetRegistryModule& AssetRegistryModule
-        = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-
-    // Force a rescan so we see latest on-disk state
-    AssetRegistryModule.Get().ScanPathsSynchronous({ RootOutputPath }, /*bForceRescan*/ true);
-
-    TArray<FAssetData> AllAssetsUnderRoot;
-    AssetRegistryModule.Get().GetAssetsByPath(FName(*RootOutputPath), AllAssetsUnderRoot, /*bRecursive*/ true);
-
-    if (AllAssetsUnderRoot.Num() == 0) {
-        UE_LOG(Retargeter, Verbose, TEXT("CleanPreviousOutputs: nothing to delete under %s"), *RootOutputPath);
-        return;
-    }
-
-    TArray<FAssetData> AssetsToDelete;
-    AssetsToDelete.Reserve(AllAssetsUnderRoot.Num());
-
-    // Only delete assets whose package path is exactly the root (exclude input/target subfolders)
-    const FName RootPathFName(*RootOutputPath);
-    for (const FAssetData& AssetData : AllAssetsUnderRoot) {
-        if (AssetData.PackagePath == RootPathFName) {
-            AssetsToDelete.Add(AssetData);
-        }
-    }
-
-    if (AssetsToDelete.Num() == 0) {
-        UE_LOG(Retargeter, Verbose, TEXT("CleanPreviousOutputs: no top-level outputs under %s"), *RootOutputPath);
+    // Outputs of the previous pair (retargeters and sequences created under the session root or transient).
+    // Cached inputs and targets are released on eviction instead.
+    if (PairCreatedObjects.Num() == 0) {
         return;
     }
-
-    UE_LOG(Retargeter, Log, TEXT("CleanPreviousOutputs: deleting %d assets under %s"), AssetsToDelete.Num(),
-        *RootOutputPath);
-    const int32 NumDeleted = ObjectTools::DeleteAssets(AssetsToDelete, /*bShowConfirmation=*/false);
-    UE_LOG(Retargeter, Log, TEXT("CleanPreviousOutputs: DeleteAssets removed %d assets"), NumDeleted);
-
-    // In commandlet mode, try to force-delete any remaining assets
-    if (IsRunningCommandlet()) {
-        TArray<FAssetData> Remaining;
-        AssetRegistryModule.Get().ScanPathsSynchronous({ RootOutputPath }, /*bForceRescan*/ true);
-        AssetRegistryModule.Get().GetAssetsByPath(RootPathFName, Remaining, /*bRecursive*/ false);
-        if (Remaining.Num() > 0) {
-            TArray<UObject*> ObjectsToForceDelete;
-            for (const FAssetData& AssetData : Remaining) {
-                if (UObject* Obj = AssetData.GetAsset({ ULevel::LoadAllExternalObjectsTag })) {
-                    ObjectsToForceDelete.Add(Obj);
-                }
-            }
-            if (ObjectsToForceDelete.Num() > 0) {
-                const int32 NumForceDeleted
-                    = ObjectTools::ForceDeleteObjects(ObjectsToForceDelete, /*ShowConfirmation=*/false);
-                UE_LOG(Retargeter, Log, TEXT("CleanPreviousOutputs: ForceDeleteObjects removed %d assets"),
-                    NumForceDeleted);
-            }
-        }
-    }
+    const int32 NumTracked = PairCreatedObjects.Num();
+    const int32 NumReleased = DeleteCreatedObjects(PairCreatedObjects);
+    UE_LOG(Retargeter, Log, TEXT("CleanPreviousOutputs: released %d of %d tracked outputs"), NumReleased, NumTracked);
 }
 
 TArray<UObject*> FRetargeterModule::ImportFBX(const FString& FbxPath, const FString& DestinationPath)
@@ -604,8 +924,11 @@ void FRetargeterModule::ProcessImportedAssets(const TArray<UObject*>& ImportedAs
     }
 }
 
-void FRetargeterModule::RetargetAPair(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath)
+bool FRetargeterModule::RetargetAPair(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath)
 {
+    const double StartTime = FPlatformTime::Seconds();
+    BeginPairMetrics(InputFbx, TargetFbx, OutputPath);
+
     // Delete any previous retargeted outputs first to avoid dangling references
     // to assets from a prior target skeleton when switching FBX files.
     CleanPreviousOutputs();
@@ -613,12 +936,384 @@ void FRetargeterModule::RetargetAPair(const FString& InputFbx, const FString& Ta
     LoadFBX(InputFbx, TargetFbx);
     CreateIkRig();
     CreateRTG();
-    RetargetWithRTG();
-    ExportOutputAnimationFBX(OutputPath);
+    const bool bWritten = RetargetWithRTG(OutputPath);
+
+    ReleasePairReferences();
+    WritePairMetrics(PairMetrics, StartTime);
+    return bWritten;
+}
+
+int32 FRetargeterModule::RetargetOneToMany(
+    const FString& InputFbx, const TArray<FString>& TargetFbxs, const TArray<FString>& OutputPaths)
+{
+    if (TargetFbxs.Num() != OutputPaths.Num()) {
+        UE_LOG(Retargeter, Error, TEXT("RetargetOneToMany: %d targets but %d output paths"), TargetFbxs.Num(),
+            OutputPaths.Num());
+        return 0;
+    }
 
+    int32 NumWritten = 0;
+
+#if WITH_EDITOR
+    // Cleanup before the first target and after the last one is charged to those targets
+    PairMetrics = FRetargetPairMetrics();
+    CleanPreviousOutputs();
+    double PendingCleanupSeconds = PairMetrics[ERetargetStage::Cleanup];
+    TOptional<FRetargetPairMetrics> LastMetrics;
+    double LastStartTime = 0.0;
+
+    // Keep every target of this batch cached until all of them are exported
+    const int64 TargetBudget = TargetCache.GetBudgetBytes();
+    TargetCache.SetBudgetBytes(MAX_int64);
+
+    TArray<FRetargetTargetJob> Jobs;
+    Jobs.Reserve(TargetFbxs.Num());
+    for (int32 TargetIndex = 0; TargetIndex < TargetFbxs.Num(); ++TargetIndex) {
+        const double StartTime = FPlatformTime::Seconds();
+        BeginPairMetrics(InputFbx, TargetFbxs[TargetIndex], OutputPaths[TargetIndex]);
+
+        // The input stays cached, so only the first target triggers its import
+        LoadFBX(InputFbx, TargetFbxs[TargetIndex]);
+        CreateIkRig();
+        CreateRTG();
+        if (!HasSourceAnimation() || !InputSkeleton || !TargetSkeleton || !IKRetargeter) {
+            UE_LOG(Retargeter, Warning, TEXT("RetargetOneToMany: skipping target %s, missing assets"),
+                *TargetFbxs[TargetIndex]);
+            continue;
+        }
+
+        FRetargetTargetJob& Job = Jobs.AddDefaulted_GetRef();
+        Job.TargetFbx = TargetFbxs[TargetIndex];
+        Job.OutputPath = OutputPaths[TargetIndex];
+        Job.TargetSkeleton = TargetSkeleton;
+        Job.IKRetargeter = IKRetargeter;
+        Job.Metrics = PairMetrics;
+        Job.StartTime = StartTime;
+        Job.Processor = MakeUnique<FIKRetargetProcessor>();
+        if (!InitializeRetargetProcessor(*Job.Processor, Job.Profile)) {
+            Jobs.Pop();
+            continue;
+        }
+        Job.Metrics[ERetargetStage::Cleanup] += PendingCleanupSeconds;
+        PendingCleanupSeconds = 0.0;
+    }
+
+    // Long clips are chunked per target instead of sharing one frame loop, so outputs match RetargetAPair
+    bool bRetargeted = false;
+    FRetargetSourcePose SourcePose;
+    const int32 NumFrames = GetSourceNumFrames();
+    if (Jobs.Num() > 0 && UsesFrameChunks(NumFrames)) {
+        const TSharedPtr<const FRetargetFbxClip> Clip = GetTaskSafeSourceClip();
+        bRetargeted = true;
+        for (int32 JobIndex = Jobs.Num() - 1; JobIndex >= 0; --JobIndex) {
+            FRetargetTargetJob& Job = Jobs[JobIndex];
+            const double RetargetStart = FPlatformTime::Seconds();
+            TargetSkeleton = Job.TargetSkeleton;
+            IKRetargeter = Job.IKRetargeter;
+            FRetargetChunkedClip Chunked;
+            if (!InitializeFrameChunks(Clip, Chunked)) {
+                Jobs.RemoveAt(JobIndex);
+                continue;
+            }
+            ProcessFrameChunks(Chunked, Job.BoneTracks);
+            Job.Metrics.NumFrames = NumFrames;
+            Job.Metrics.NumBones = Job.BoneTracks.Num();
+            Job.Metrics[ERetargetStage::Retarget] += FPlatformTime::Seconds() - RetargetStart;
+        }
+    } else if (Jobs.Num() > 0
+        && SourcePose.Initialize(
+            InputAnimation, InputClip, Jobs[0].Processor->GetSkeleton(ERetargetSourceOrTarget::Source))) {
+        const FRetargetSkeleton& SourceRig = Jobs[0].Processor->GetSkeleton(ERetargetSourceOrTarget::Source);
+        const TArray<FName>& SourceBoneNames = SourceRig.BoneNames;
+        bRetargeted = true;
+
+        for (FRetargetTargetJob& Job : Jobs) {
+            const int32 NumTargetBones = Job.Processor->GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames.Num();
+            AllocateBoneTracks(Job.BoneTracks, NumTargetBones, NumFrames);
+            Job.SourcePose.SetNum(SourceBoneNames.Num());
+            Job.TargetLocalPose.SetNum(NumTargetBones);
+            Job.SimdScratch.SetNum(NumTargetBones);
+            Job.Processor->OnPlaybackReset();
+            Job.Metrics.NumFrames = NumFrames;
+            Job.Metrics.NumBones = NumTargetBones;
+        }
+
+        TArray<FTransform> SourceComponentPose;
+        SourceComponentPose.SetNum(SourceBoneNames.Num());
+
+        const double RetargetStart = FPlatformTime::Seconds();
+        for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex) {
+            const uint64 AllocsBefore = FRetargetAllocCounter::GetThreadAllocs();
+            EvaluateSourceFrame(FrameIndex, SourcePose, SourceComponentPose);
+
+            const float DeltaTime = SourcePose.GetDeltaTime(FrameIndex);
+            for (FRetargetTargetJob& Job : Jobs) {
+                // The retargeter may modify its input pose, so each target gets its own copy
+                CopyPose(SourceComponentPose, Job.SourcePose);
+                // Each target's retargeter carries its own source scale
+                Job.Processor->ScaleSourcePose(Job.SourcePose);
+                const FRetargetSkeleton& TargetRig = Job.Processor->GetSkeleton(ERetargetSourceOrTarget::Target);
+                const float SimdError = RetargetFrame(*Job.Processor, TargetRig, Job.Profile, Job.SourcePose,
+                    DeltaTime, FrameIndex, Job.TargetLocalPose, Job.SimdScratch, Job.BoneTracks);
+                SimdMaxError = FMath::Max(SimdMaxError, SimdError);
+            }
+            RecordFrameAllocations(AllocsBefore);
+        }
+        // The frame loop is shared, so each target is charged an equal part of it
+        const double RetargetSeconds = (FPlatformTime::Seconds() - RetargetStart) / Jobs.Num();
+        for (FRetargetTargetJob& Job : Jobs) {
+            Job.Metrics[ERetargetStage::Retarget] += RetargetSeconds;
+        }
+    }
+
+    if (bRetargeted) {
+        for (FRetargetTargetJob& Job : Jobs) {
+            CurrentTargetFbx = Job.TargetFbx;
+            TargetSkeleton = Job.TargetSkeleton;
+            IKRetargeter = Job.IKRetargeter;
+            PairMetrics = MoveTemp(Job.Metrics);
+            const FRetargetSkeleton& TargetRig = Job.Processor->GetSkeleton(ERetargetSourceOrTarget::Target);
+            NumWritten += WriteOutput(Job.OutputPath, Job.BoneTracks, TargetRig.BoneNames) ? 1 : 0;
+            outputAnimation = nullptr;
+            if (&Job == &Jobs.Last()) {
+                // Written once the batch's cache eviction is done
+                LastMetrics = MoveTemp(PairMetrics);
+                LastStartTime = Job.StartTime;
+                break;
+            }
+            // Every target counts as a pair for the GC policy; targets still to be written are standalone or cached
+            if (IsRunningCommandlet()) {
+                PairMetrics[ERetargetStage::GC] += GCPolicy.OnPairFinished();
+            }
+            WritePairMetrics(PairMetrics, Job.StartTime);
+        }
+    }
+    Jobs.Empty();
+
+    PairMetrics = FRetargetPairMetrics();
+    TArray<FRetargetCachedAssets> Evicted;
+    TargetCache.SetBudgetBytes(TargetBudget);
+    TargetCache.Trim(Evicted);
+    ReleaseCachedAssets(Evicted);
+    if (LastMetrics) {
+        (*LastMetrics)[ERetargetStage::Cleanup] += PairMetrics[ERetargetStage::Cleanup];
+        if (IsRunningCommandlet()) {
+            (*LastMetrics)[ERetargetStage::GC] += GCPolicy.OnPairFinished();
+        }
+        WritePairMetrics(*LastMetrics, LastStartTime);
+    }
+#else
+    UE_LOG(Retargeter, Warning, TEXT("RetargetOneToMany is editor-only and not available in this build"));
+#endif
+
+    ReleasePairReferences(false);
+    return NumWritten;
+}
+
+void FRetargeterModule::SetPipelineDepth(int32 Depth)
+{
+    PipelineDepth = FMath::Max(1, Depth);
+    UE_LOG(Retargeter, Log, TEXT("PipelineDepth=%d"), PipelineDepth);
+}
+
+int32 FRetargeterModule::RetargetPairs(
+    const TArray<FString>& InputFbxs, const TArray<FString>& TargetFbxs, const TArray<FString>& OutputPaths)
+{
+    if (InputFbxs.Num() != TargetFbxs.Num() || TargetFbxs.Num() != OutputPaths.Num()) {
+        UE_LOG(Retargeter, Error, TEXT("RetargetPairs: %d inputs, %d targets and %d output paths"), InputFbxs.Num(),
+            TargetFbxs.Num(), OutputPaths.Num());
+        return 0;
+    }
+
+    int32 NumWritten = 0;
+#if WITH_EDITOR
+    if (PipelineDepth <= 1) {
+        for (int32 PairIndex = 0; PairIndex < InputFbxs.Num(); ++PairIndex) {
+            NumWritten += RetargetAPair(InputFbxs[PairIndex], TargetFbxs[PairIndex], OutputPaths[PairIndex]) ? 1 : 0;
+        }
+        return NumWritten;
+    }
+
+    // Cleanup before the first pair and after the last one is charged to those pairs
+    PairMetrics = FRetargetPairMetrics();
+    CleanPreviousOutputs();
+    double PendingCleanupSeconds = PairMetrics[ERetargetStage::Cleanup];
+    TOptional<FRetargetPairMetrics> LastMetrics;
+    double LastStartTime = 0.0;
+
+    // Pairs in flight still use their cached meshes and clips, so nothing is evicted until the list is done
+    const int64 SourceBudget = SourceCache.GetBudgetBytes();
+    const int64 TargetBudget = TargetCache.GetBudgetBytes();
+    SourceCache.SetBudgetBytes(MAX_int64);
+    TargetCache.SetBudgetBytes(MAX_int64);
+
+    // Output stages that need UObjects run here on the game thread; file output runs as a task
+    const bool bOutputOnTask = ShardSink.IsValid() || bDirectFbxExport;
+    auto FinishOldestPair = [this, bOutputOnTask, &NumWritten, &LastMetrics, &LastStartTime](
+                                TArray<TUniquePtr<FRetargetPipelinePair>>& InFlight, bool bLastPair) {
+        FRetargetPipelinePair& Pair = *InFlight[0];
+        Pair.RetargetTask.Wait();
+        if (bOutputOnTask) {
+            Pair.OutputTask.Wait();
+        } else {
+            CurrentInputFbx = Pair.InputFbx;
+            CurrentTargetFbx = Pair.TargetFbx;
+            InputAnimation = Pair.InputAnimation.Get();
+            InputClip = Pair.InputClip;
+            InputSkeleton = Pair.InputSkeleton.Get();
+            TargetSkeleton = Pair.TargetSkeleton.Get();
+            IKRetargeter = Pair.IKRetargeter.Get();
+            PairMetrics = MoveTemp(Pair.Metrics);
+            Pair.bWritten = WriteOutput(Pair.OutputPath, Pair.BoneTracks, Pair.TargetBoneNames);
+            ReleasePairReferences(false);
+            Pair.Metrics = MoveTemp(PairMetrics);
+        }
+        NumWritten += Pair.bWritten ? 1 : 0;
+        FRetargetPairMetrics Metrics = MoveTemp(Pair.Metrics);
+        const double StartTime = Pair.StartTime;
+        InFlight.RemoveAt(0);
+        if (bLastPair) {
+            // Written once the list's cache eviction is done
+            LastMetrics = MoveTemp(Metrics);
+            LastStartTime = StartTime;
+            return;
+        }
+
+        // The finished pair no longer holds its assets, so the policy may collect them; pairs in flight keep theirs
+        if (IsRunningCommandlet()) {
+            Metrics[ERetargetStage::GC] += GCPolicy.OnPairFinished();
+        }
+        WritePairMetrics(Metrics, StartTime);
+    };
+
+    TArray<TUniquePtr<FRetargetPipelinePair>> InFlight;
+    UE::Tasks::FTask LastRetargetTask, LastOutputTask;
+    for (int32 PairIndex = 0; PairIndex < InputFbxs.Num(); ++PairIndex) {
+        while (InFlight.Num() >= PipelineDepth) {
+            FinishOldestPair(InFlight, false);
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        BeginPairMetrics(InputFbxs[PairIndex], TargetFbxs[PairIndex], OutputPaths[PairIndex]);
+        LoadFBX(InputFbxs[PairIndex], TargetFbxs[PairIndex]);
+        CreateIkRig();
+        CreateRTG();
+        if (!HasSourceAnimation() || !InputSkeleton || !TargetSkeleton || !IKRetargeter) {
+            UE_LOG(Retargeter, Warning, TEXT("RetargetPairs: skipping %s -> %s, missing assets"), *InputFbxs[PairIndex],
+                *TargetFbxs[PairIndex]);
+            ReleasePairReferences(false);
+            continue;
+        }
+
+        TUniquePtr<FRetargetPipelinePair> Pair = MakeUnique<FRetargetPipelinePair>();
+        Pair->InputFbx = InputFbxs[PairIndex];
+        Pair->TargetFbx = TargetFbxs[PairIndex];
+        Pair->OutputPath = OutputPaths[PairIndex];
+        Pair->InputAnimation.Reset(InputAnimation);
+        Pair->InputSkeleton.Reset(InputSkeleton);
+        Pair->TargetSkeleton.Reset(TargetSkeleton);
+        Pair->InputIKRig.Reset(InputIKRig);
+        Pair->TargetIKRig.Reset(TargetIKRig);
+        Pair->IKRetargeter.Reset(IKRetargeter);
+        Pair->InputClip = InputClip;
+        Pair->TargetRefSkeleton = TargetSkeleton->GetRefSkeleton();
+        Pair->FrameRate = GetSourceFrameRate();
+        Pair->NumFrames = GetSourceNumFrames();
+        Pair->Metrics = PairMetrics;
+        Pair->StartTime = StartTime;
+        Pair->TaskClip = GetTaskSafeSourceClip();
+        const bool bChunked = UsesFrameChunks(Pair->NumFrames);
+        bool bReady = false;
+        if (bChunked) {
+            bReady = InitializeFrameChunks(Pair->TaskClip, Pair->Chunked);
+        } else {
+            bReady = Pair->TaskClip && InitializeRetargetProcessor(Pair->Processor, Pair->Profile)
+                && Pair->SourcePose.Initialize(
+                    nullptr, Pair->TaskClip, Pair->Processor.GetSkeleton(ERetargetSourceOrTarget::Source));
+        }
+        ReleasePairReferences(false);
+        if (!bReady) {
+            continue;
+        }
+        Pair->Metrics[ERetargetStage::Cleanup] += PendingCleanupSeconds;
+        PendingCleanupSeconds = 0.0;
+
+        const FIKRetargetProcessor& Processor = bChunked ? Pair->Chunked.Chunks[0]->Processor : Pair->Processor;
+        Pair->TargetBoneNames = Processor.GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames;
+        const int32 NumTargetBones = Pair->TargetBoneNames.Num();
+        if (!bChunked) {
+            Pair->SourceComponentPose.SetNum(Processor.GetSkeleton(ERetargetSourceOrTarget::Source).BoneNames.Num());
+            AllocateBoneTracks(Pair->BoneTracks, NumTargetBones, Pair->NumFrames);
+        }
+        Pair->Metrics.NumFrames = Pair->NumFrames;
+        Pair->Metrics.NumBones = NumTargetBones;
+
+        // Retarget tasks run one after another so the debug counters are never updated concurrently.
+        // They only read the pair's clip and processors, never UObjects.
+        FRetargetPipelinePair* PairPtr = Pair.Get();
+        Pair->RetargetTask = UE::Tasks::Launch(
+            UE_SOURCE_LOCATION,
+            [this, PairPtr, bChunked, NumTargetBones]() {
+                FRetargetStageScope Scope(PairPtr->Metrics, ERetargetStage::Retarget);
+                if (bChunked) {
+                    ProcessFrameChunks(PairPtr->Chunked, PairPtr->BoneTracks);
+                    return;
+                }
+                ProcessFrameRetargeting(PairPtr->Processor, PairPtr->Profile,
+                    PairPtr->Processor.GetSkeleton(ERetargetSourceOrTarget::Target), PairPtr->SourceComponentPose,
+                    PairPtr->BoneTracks, PairPtr->SourcePose, PairPtr->NumFrames, NumTargetBones);
+            },
+            UE::Tasks::Prerequisites(LastRetargetTask));
+        LastRetargetTask = Pair->RetargetTask;
+
+        // Outputs are written in pair order, one at a time, so the shard sink sees a single writer
+        if (bOutputOnTask) {
+            Pair->OutputTask = UE::Tasks::Launch(
+                UE_SOURCE_LOCATION,
+                [this, PairPtr]() {
+                    PairPtr->bWritten = WriteTracksToFile(PairPtr->OutputPath,
+                        FPaths::GetBaseFilename(PairPtr->InputFbx), FPaths::GetBaseFilename(PairPtr->TargetFbx),
+                        PairPtr->TargetRefSkeleton, PairPtr->BoneTracks, PairPtr->FrameRate, PairPtr->Metrics);
+                },
+                UE::Tasks::Prerequisites(Pair->RetargetTask, LastOutputTask));
+            LastOutputTask = Pair->OutputTask;
+        }
+        InFlight.Add(MoveTemp(Pair));
+    }
+    while (InFlight.Num() > 0) {
+        FinishOldestPair(InFlight, InFlight.Num() == 1);
+    }
+
+    PairMetrics = FRetargetPairMetrics();
+    TArray<FRetargetCachedAssets> Evicted;
+    SourceCache.SetBudgetBytes(SourceBudget);
+    TargetCache.SetBudgetBytes(TargetBudget);
+    SourceCache.Trim(Evicted);
+    TargetCache.Trim(Evicted);
+    ReleaseCachedAssets(Evicted);
+    if (LastMetrics) {
+        (*LastMetrics)[ERetargetStage::Cleanup] += PairMetrics[ERetargetStage::Cleanup];
+        if (IsRunningCommandlet()) {
+            (*LastMetrics)[ERetargetStage::GC] += GCPolicy.OnPairFinished();
+        }
+        WritePairMetrics(*LastMetrics, LastStartTime);
+    }
+#else
+    UE_LOG(Retargeter, Warning, TEXT("RetargetPairs is editor-only and not available in this build"));
+#endif
+
+    // Garbage was already collected per pair by FinishOldestPair
+    ReleasePairReferences(false);
+    return NumWritten;
+}
+
+void FRetargeterModule::ReleasePairReferences(bool bCollectGarbage)
+{
     // Release references to created/imported assets so they can be garbage collected
-    // Clearing member pointers avoids holding onto transient or editor-only assets
+    // Clearing member pointers avoids holding onto transient or editor-only assets.
+    // Cached meshes, animations and rigs stay rooted until evicted from their cache.
     InputAnimation = nullptr;
+    InputClip.Reset();
     InputSkeleton = nullptr;
     TargetSkeleton = nullptr;
 
@@ -628,71 +1323,245 @@ void FRetargeterModule::RetargetAPair(const FString& InputFbx, const FString& Ta
     IKRetargeter = nullptr;
     outputAnimation = nullptr;
 
-    // In commandlet/batch mode, run a GC pass to free transient assets immediately.
-    if (IsRunningCommandlet()) {
-        UE_LOG(Retargeter, Log, TEXT("RetargetAPair: running garbage collection to free transient assets"));
-        CollectGarbage(RF_NoFlags);
+    UE_LOG(Retargeter, Log, TEXT("Pair cleanup: %.1f ms deleting tracked objects"),
+        PairMetrics[ERetargetStage::Cleanup] * 1000.0);
+
+    // In commandlet/batch mode the GC policy decides when to free transient assets
+    if (bCollectGarbage && IsRunningCommandlet()) {
+        PairMetrics[ERetargetStage::GC] += GCPolicy.OnPairFinished();
+    }
+}
+
+void FRetargeterModule::BeginPairMetrics(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath)
+{
+    PairMetrics = FRetargetPairMetrics();
+    PairMetrics.InputFbx = InputFbx;
+    PairMetrics.TargetFbx = TargetFbx;
+    PairMetrics.OutputPath = OutputPath;
+}
+
+void FRetargeterModule::WritePairMetrics(FRetargetPairMetrics& Metrics, double StartTime)
+{
+    if (MetricsWriter) {
+        Metrics.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+        Metrics.PeakRssBytes = int64(FPlatformMemory::GetStats().PeakUsedPhysical);
+        MetricsWriter->Write(Metrics);
+    }
+}
+
+void FRetargeterModule::SetSourceCacheBudgetMB(int32 BudgetMB)
+{
+    SourceCache.SetBudgetBytes(int64(BudgetMB) * 1024 * 1024);
+    UE_LOG(Retargeter, Log, TEXT("SourceCacheBudgetMB=%d"), BudgetMB);
+}
+
+void FRetargeterModule::SetTargetCacheBudgetMB(int32 BudgetMB)
+{
+    TargetCache.SetBudgetBytes(int64(BudgetMB) * 1024 * 1024);
+    UE_LOG(Retargeter, Log, TEXT("TargetCacheBudgetMB=%d"), BudgetMB);
+}
+
+void FRetargeterModule::ReleaseSourceCache()
+{
+    TArray<FRetargetCachedAssets> Evicted;
+    SourceCache.Empty(Evicted);
+    ReleaseCachedAssets(Evicted);
+}
+
+void FRetargeterModule::ReleaseTargetCache()
+{
+    TArray<FRetargetCachedAssets> Evicted;
+    TargetCache.Empty(Evicted);
+    ReleaseCachedAssets(Evicted);
+}
+
+const FString& FRetargeterModule::GetSessionPackageRoot()
+{
+    if (SessionPackageRoot.IsEmpty()) {
+        SessionPackageRoot = MakeSessionPackageRoot();
+    }
+    return SessionPackageRoot;
+}
+
+FString FRetargeterModule::GetSettingsFingerprint() const
+{
+    FString PluginVersion = TEXT("unknown");
+    if (TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("Retargeter"))) {
+        PluginVersion = FString::Printf(
+            TEXT("%d-%s"), Plugin->GetDescriptor().Version, *Plugin->GetDescriptor().VersionName);
+    }
+    FString Fingerprint = FString::Printf(TEXT("plugin=%s;settings=%d;directfbx=%d;directexport=%d"), *PluginVersion,
+        RetargetSettingsVersion, bDirectFbxImport ? 1 : 0, bDirectFbxExport ? 1 : 0);
+    // Key reduction only applies to direct FBX export
+    if (bReduceKeys && bDirectFbxExport) {
+        Fingerprint += TEXT(";reducekeys=1");
+    }
+    // -nocompress is left out: outputs are exported from the raw data model either way, which the benchmark's
+    // -validatecompress checks.
+    // Warm-up only approximates playback state, so chunked outputs are keyed separately
+    if (FrameChunkFrames > 0) {
+        Fingerprint += FString::Printf(TEXT(";framechunk=%d;warmup=%d"), FrameChunkFrames, FrameChunkWarmup);
+    }
+    return Fingerprint;
+}
+
+void FRetargeterModule::ReleaseCachedAssets(TArray<FRetargetCachedAssets>& Evicted)
+{
+    for (const FRetargetCachedAssets& Entry : Evicted) {
+        UE_LOG(Retargeter, Log, TEXT("Evicting cached assets of %s (%lld bytes)"), *Entry.FbxPath, Entry.SizeBytes);
+        TArray<TWeakObjectPtr<UObject>> Objects = Entry.CreatedObjects;
+        if (Entry.IKRig) {
+            Objects.Add(Entry.IKRig);
+        }
+        DeleteCreatedObjects(Objects);
+    }
+    Evicted.Reset();
+}
+
+bool FRetargeterModule::LoadCachedFBX(FRetargetAssetCache& Cache, const FString& FbxPath, bool bIsInput)
+{
+    if (FRetargetCachedAssets* Cached = Cache.Find(FbxPath)) {
+        UE_LOG(Retargeter, Log, TEXT("LoadFBX: reusing cached %s %s"), bIsInput ? TEXT("input") : TEXT("target"),
+            *FbxPath);
+        if (bIsInput) {
+            InputAnimation = Cached->Animation;
+            InputClip = Cached->Clip;
+            InputSkeleton = Cached->Mesh;
+            InputIKRig = Cached->IKRig;
+        } else {
+            TargetSkeleton = Cached->Mesh;
+            TargetIKRig = Cached->IKRig;
+        }
+        return true;
+    }
+
+    // Each cached file gets its own package path so imports do not replace cached assets
+    const FString PackagePath = FString::Printf(TEXT("%s/%s/%d"), *GetSessionPackageRoot(),
+        bIsInput ? TEXT("input") : TEXT("target"), NextCachePackageId++);
+
+    PairMetrics.BytesRead += FMath::Max<int64>(0, IFileManager::Get().FileSize(*FbxPath));
+    if (bDirectFbxImport) {
+        FRetargetCachedAssets Entry;
+        Entry.PackagePath = PackagePath;
+        if (!ReadFBXDirect(FbxPath, bIsInput, Entry)) {
+            return false;
+        }
+        TArray<FRetargetCachedAssets> Evicted;
+        Cache.Add(MoveTemp(Entry), Evicted);
+        ReleaseCachedAssets(Evicted);
+        return true;
+    }
+
+    // The package path is new to this session, so there is nothing to clear before importing.
+    // Imported source sequences are compressed by the import itself; only -directfbx avoids that.
+    TArray<UObject*> Assets = ImportFBX(FbxPath, PackagePath);
+    ProcessImportedAssets(Assets, bIsInput);
+
+    const bool bOk = bIsInput ? (InputAnimation && InputSkeleton) : (TargetSkeleton != nullptr);
+    if (!bOk) {
+        // A partial import is not cached, so delete whatever it created now
+        UE_LOG(Retargeter, Warning, TEXT("LoadFBX: incomplete import of %s, deleting %d partial assets"), *FbxPath,
+            Assets.Num());
+        TArray<TWeakObjectPtr<UObject>> Partial;
+        Partial.Append(Assets);
+        DeleteCreatedObjects(Partial);
+        if (bIsInput) {
+            InputAnimation = nullptr;
+            InputSkeleton = nullptr;
+        } else {
+            TargetSkeleton = nullptr;
+        }
+        return false;
+    }
+
+    FRetargetCachedAssets Entry;
+    Entry.FbxPath = FbxPath;
+    Entry.PackagePath = PackagePath;
+    Entry.Animation = bIsInput ? InputAnimation : nullptr;
+    Entry.Mesh = bIsInput ? InputSkeleton : TargetSkeleton;
+    Entry.CreatedObjects.Append(Assets);
+
+    TArray<FRetargetCachedAssets> Evicted;
+    Cache.Add(MoveTemp(Entry), Evicted);
+    ReleaseCachedAssets(Evicted);
+    return true;
+}
+
+bool FRetargeterModule::ReadFBXDirect(const FString& FbxPath, bool bIsInput, FRetargetCachedAssets& OutEntry)
+{
+    TSharedPtr<FRetargetFbxClip> Clip = MakeShared<FRetargetFbxClip>();
+    if (!RetargetFbx::ReadFbx(FbxPath, bIsInput, *Clip)) {
+        return false;
     }
+
+    USkeletalMesh* Mesh = RetargetFbx::CreateTransientMesh(Clip->RefSkeleton, FPaths::GetBaseFilename(FbxPath));
+    UE_LOG(Retargeter, Log, TEXT("Read %s %s directly: %d bones, %d frames"), bIsInput ? TEXT("input") : TEXT("target"),
+        *FbxPath, Clip->NumBones(), Clip->NumFrames);
+
+    OutEntry.FbxPath = FbxPath;
+    OutEntry.Mesh = Mesh;
+    if (bIsInput) {
+        InputSkeleton = Mesh;
+        InputClip = Clip;
+        OutEntry.Clip = Clip;
+    } else {
+        TargetSkeleton = Mesh;
+    }
+    return true;
+}
+
+bool FRetargeterModule::HasSourceAnimation() const { return InputAnimation != nullptr || InputClip.IsValid(); }
+
+int32 FRetargeterModule::GetSourceNumFrames() const
+{
+    return InputClip ? InputClip->NumFrames : InputAnimation->GetDataModel()->GetNumberOfFrames();
+}
+
+FFrameRate FRetargeterModule::GetSourceFrameRate() const
+{
+    return InputClip ? InputClip->FrameRate : InputAnimation->GetDataModel()->GetFrameRate();
 }
 
 void FRetargeterModule::LoadFBX(const FString& InputFbx, const FString& TargetFbx)
 {
     UE_LOG(Retargeter, Log, TEXT("loadFBX called with Input: %s, Target: %s"), *InputFbx, *TargetFbx);
+    FRetargetStageScope Scope(PairMetrics, ERetargetStage::Load);
 
     // Unique session dir (diagnostic separation)
     const FString Session = GetRetargetSessionSuffix();
     const FString SessionDir = FPaths::ProjectSavedDir() / TEXT("Interchange/Sessions/") / Session;
     IFileManager::Get().MakeDirectory(*SessionDir, /*Tree*/ true);
 
-    // Ensure output temp folders exist
-    ClearAssetsInPath(TEXT("/Game/Animations/tmp/input"));
-    ClearAssetsInPath(TEXT("/Game/Animations/tmp/target"));
-
-    // Lock paths
-    const FString LockDir = FPaths::ProjectSavedDir() / TEXT("Interchange/Locks");
-    IFileManager::Get().MakeDirectory(*LockDir, /*Tree*/ true);
-    const FString LockFile = LockDir / TEXT("import_global.lock");
+    CurrentInputFbx = InputFbx;
+    CurrentTargetFbx = TargetFbx;
+    InputAnimation = nullptr;
+    InputClip.Reset();
+    InputSkeleton = nullptr;
+    InputIKRig = nullptr;
+    TargetSkeleton = nullptr;
+    TargetIKRig = nullptr;
 
-    int LockFd = -1;
-    const int MaxWaitMs = 10000; // 10s
-    const int SleepMs = 50;
     const int MaxRetries = 2;
 
     auto DoImports = [&](int Attempt)->bool {
-        // Import input FBX
-        TArray<UObject*> InputAssets = ImportFBX(InputFbx, TEXT("/Game/Animations/tmp/input"));
-        ProcessImportedAssets(InputAssets, true);
+        // Import input and target FBX unless already cached
+        LoadCachedFBX(SourceCache, InputFbx, true);
+        LoadCachedFBX(TargetCache, TargetFbx, false);
 
-        // Import target FBX
-        TArray<UObject*> TargetAssets = ImportFBX(TargetFbx, TEXT("/Game/Animations/tmp/target"));
-        ProcessImportedAssets(TargetAssets, false);
-
-        const bool bOk = (InputAnimation != nullptr) && (InputSkeleton != nullptr) && (TargetSkeleton != nullptr);
+        const bool bOk = HasSourceAnimation() && (InputSkeleton != nullptr) && (TargetSkeleton != nullptr);
         if (!bOk) {
             UE_LOG(Retargeter, Warning, TEXT("LoadFBX attempt %d: missing imported assets (InputAnim=%s InputSkel=%s TargetSkel=%s)"),
-                Attempt, (InputAnimation ? TEXT("true") : TEXT("false")), (InputSkeleton ? TEXT("true") : TEXT("false")),
+                Attempt, (HasSourceAnimation() ? TEXT("true") : TEXT("false")), (InputSkeleton ? TEXT("true") : TEXT("false")),
                 (TargetSkeleton ? TEXT("true") : TEXT("false")));
         }
         return bOk;
     };
 
+    // Imports land under this session's own package root, so workers do not serialize on a shared lock
     bool bImported = false;
     for (int Attempt = 0; Attempt <= MaxRetries && !bImported; ++Attempt) {
-        if (!AcquireFileLock(LockFile, MaxWaitMs, SleepMs, LockFd)) {
-            UE_LOG(Retargeter, Warning, TEXT("LoadFBX: could not acquire Interchange lock, attempt %d (continuing without lock)"), Attempt);
-            LockFd = -1;
-        } else {
-            UE_LOG(Retargeter, Verbose, TEXT("LoadFBX: acquired Interchange lock (fd=%d)"), LockFd);
-        }
-
         bImported = DoImports(Attempt);
 
-        // Release lock before potential retry or return
-        if (LockFd != -1) {
-            ReleaseFileLock(LockFile, LockFd);
-            LockFd = -1;
-        }
-
         if (!bImported && Attempt < MaxRetries) {
             const float Backoff = 0.10f + 0.15f * Attempt; // 100C250ms
             FPlatformProcess::Sleep(Backoff);
@@ -785,11 +1654,10 @@ TMap<FName, TPair<FName, FName>> FRetargeterModule::GenerateRetargetChains(USkel
 
 void FRetargeterModule::CreateIkRig()
 {
+    FRetargetStageScope Scope(PairMetrics, ERetargetStage::IkRig);
     UE_LOG(Retargeter, Log, TEXT("createIkRig called"));
 
-    // Clear any existing generated rigs
-    InputIKRig = nullptr;
-    TargetIKRig = nullptr;
+    // Rigs already generated for cached meshes are reused as-is; a mesh seen for the first time gets its own rig
 
     // Need skeletons to operate
     if (!InputSkeleton && !TargetSkeleton) {
@@ -867,15 +1735,26 @@ void FRetargeterModule::CreateIkRig()
         }
     };
 
-    // Generate for both skeletons
-    GenerateForMesh(InputSkeleton, InputIKRig, TEXT("/Game/Animations/tmp/input"));
-    GenerateForMesh(TargetSkeleton, TargetIKRig, TEXT("/Game/Animations/tmp/target"));
+    // Generate for both skeletons, next to the cached meshes
+    if (!InputIKRig) {
+        if (const FRetargetCachedAssets* Entry = SourceCache.Find(CurrentInputFbx)) {
+            GenerateForMesh(InputSkeleton, InputIKRig, Entry->PackagePath);
+            SourceCache.SetIKRig(CurrentInputFbx, InputIKRig);
+        }
+    }
+    if (!TargetIKRig) {
+        if (const FRetargetCachedAssets* Entry = TargetCache.Find(CurrentTargetFbx)) {
+            GenerateForMesh(TargetSkeleton, TargetIKRig, Entry->PackagePath);
+            TargetCache.SetIKRig(CurrentTargetFbx, TargetIKRig);
+        }
+    }
 
     // Generated rigs are stored in InputIKRig and TargetIKRig members for later use
 }
 
 void FRetargeterModule::CreateRTG()
 {
+    FRetargetStageScope Scope(PairMetrics, ERetargetStage::RTG);
     UE_LOG(Retargeter, Log, TEXT("createRTG called"));
 
 #if WITH_EDITOR
@@ -893,7 +1772,7 @@ void FRetargeterModule::CreateRTG()
     FString UniqueAssetName = FString::Printf(TEXT("RTG_%s"), *BaseName);
 
     // Decide package path - keep consistent with IKRig saving path
-    FString PackagePath = TEXT("/Game/Animations/tmp");
+    const FString& PackagePath = GetSessionPackageRoot();
     FString DesiredPackage = PackagePath / UniqueAssetName;
 
     const FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
@@ -922,6 +1801,7 @@ void FRetargeterModule::CreateRTG()
         return;
     }
     IKRetargeter = RetargetAsset;
+    PairCreatedObjects.Add(RetargetAsset);
 
     // Use controller to assign IKRigs and setup default ops
     const UIKRetargeterController* Controller = UIKRetargeterController::GetController(RetargetAsset);
@@ -991,12 +1871,12 @@ void FRetargeterModule::CreateRTG()
 
 IMPLEMENT_MODULE(FRetargeterModule, Retargeter)
 
-void FRetargeterModule::ExportOutputAnimationFBX(const FString& OutputPath)
+bool FRetargeterModule::ExportOutputAnimationFBX(const FString& OutputPath)
 {
 #if WITH_EDITOR
     if (!outputAnimation || !TargetSkeleton) {
         UE_LOG(Retargeter, Warning, TEXT("ExportOutputAnimationFBX: Missing outputAnimation or TargetSkeleton"));
-        return;
+        return false;
     }
 
     // Prepare automated export task and options
@@ -1028,7 +1908,9 @@ void FRetargeterModule::ExportOutputAnimationFBX(const FString& OutputPath)
 
     bool bOk = UExporter::RunAssetExportTask(Task);
     UE_LOG(Retargeter, Log, TEXT("Export FBX %s: %s"), bOk ? TEXT("succeeded") : TEXT("failed"), *CleanOutputPath);
+    return bOk;
 #else
     UE_LOG(Retargeter, Warning, TEXT("ExportOutputAnimationFBX is editor-only and not available in this build"));
+    return false;
 #endif
 }
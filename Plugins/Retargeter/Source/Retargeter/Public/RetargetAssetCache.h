@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+class USkeletalMesh;
+class UIKRigDefinition;
+struct FRetargetFbxClip;
+
+// Assets imported from a single FBX file. Objects are rooted while the entry is cached.
+struct FRetargetCachedAssets {
+    FString FbxPath;
+    FString PackagePath;
+    UAnimSequence* Animation = nullptr;
+    USkeletalMesh* Mesh = nullptr;
+    UIKRigDefinition* IKRig = nullptr;
+    // Everything the import created, deleted with the entry on eviction
+    TArray<TWeakObjectPtr<UObject>> CreatedObjects;
+    // Raw source animation when the file was read directly instead of imported
+    TSharedPtr<const FRetargetFbxClip> Clip;
+    int64 SizeBytes = 0;
+};
+
+/**
+ * Least-recently-used cache of imported FBX assets, bounded by an estimated memory budget.
+ * The most recently added entry is always kept, so a zero budget behaves as a single-entry cache.
+ */
+class FRetargetAssetCache {
+public:
+    void SetBudgetBytes(int64 InBudgetBytes);
+    int64 GetBudgetBytes() const { return BudgetBytes; }
+
+    // Returns the entry for FbxPath and marks it as most recently used, or nullptr.
+    FRetargetCachedAssets* Find(const FString& FbxPath);
+
+    // Roots the entry's objects and evicts old entries over budget. Evicted entries are unrooted
+    // and returned so the caller can delete their packages.
+    void Add(FRetargetCachedAssets&& Entry, TArray<FRetargetCachedAssets>& OutEvicted);
+    void SetIKRig(const FString& FbxPath, UIKRigDefinition* IKRig);
+
+    // Evicts least-recently-used entries until the cache fits its budget
+    void Trim(TArray<FRetargetCachedAssets>& OutEvicted);
+
+    void Empty(TArray<FRetargetCachedAssets>& OutEvicted);
+    int32 Num() const { return Entries.Num(); }
+    int64 GetTotalBytes() const { return TotalBytes; }
+
+private:
+    void Evict(int32 Index, TArray<FRetargetCachedAssets>& OutEvicted);
+
+    // Oldest first, most recently used last
+    TArray<FRetargetCachedAssets> Entries;
+    int64 BudgetBytes = 0;
+    int64 TotalBytes = 0;
+};
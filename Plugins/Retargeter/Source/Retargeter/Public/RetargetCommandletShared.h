@@ -1,6 +1,15 @@
 #pragma once
 
+#include "CoreMinimal.h"
 #include "Logging/LogMacros.h"
 
 // Shared log category for all retarget commandlets
 DECLARE_LOG_CATEGORY_EXTERN(RetargetAllCommandlet, Log, All);
+
+namespace RetargetCommandlet {
+// Full paths of the .fbx files in DirectoryPath, sorted so every run and worker sees the same order
+TArray<FString> GetFBXFiles(const FString& DirectoryPath);
+
+// Count elements of InputArray picked by a Fisher-Yates shuffle seeded with Seed; all of them if Count is larger
+TArray<FString> GetRandomSubset(const TArray<FString>& InputArray, int32 Count, int32 Seed);
+} // namespace RetargetCommandlet
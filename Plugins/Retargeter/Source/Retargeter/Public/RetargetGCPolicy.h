@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Garbage collections run since the stats were last consumed
+struct FRetargetGCStats {
+    int32 NumPairs = 0;
+    int32 NumCollections = 0;
+    double Seconds = 0.0;
+    // Resident memory and live objects freed by the collections; memory can be negative when the
+    // allocator keeps freed pages
+    int64 ReclaimedBytes = 0;
+    int32 ReclaimedObjects = 0;
+};
+
+/**
+ * Decides when to run a full garbage collection between pairs. A collection runs once resident memory
+ * reaches RssMB, the live UObject count reaches Objects, or EveryPairs pairs finished since the last one.
+ * Zero disables a threshold; the default collects after every pair.
+ */
+class FRetargetGCPolicy {
+public:
+    void SetThresholds(int32 InRssMB, int32 InObjects, int32 InEveryPairs);
+
+    // Called after each pair; collects when a threshold is reached and returns the seconds spent
+    double OnPairFinished();
+
+    // Stats gathered since the last call
+    FRetargetGCStats ConsumeStats();
+
+private:
+    // Returns the threshold that triggered, or nullptr
+    const TCHAR* GetCollectReason() const;
+    double Collect(const TCHAR* Reason);
+
+    int32 RssMB = 0;
+    int32 Objects = 0;
+    int32 EveryPairs = 1;
+    int32 PairsSinceCollect = 0;
+    FRetargetGCStats Stats;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+class FArchive;
+
+// Stages of a pair, in the order they run
+enum class ERetargetStage : uint8 { Load, IkRig, RTG, Retarget, Commit, Finalize, Export, Cleanup, GC, Num };
+
+// Timings and sizes of one retargeted pair, written as one JSON line
+struct FRetargetPairMetrics {
+    FString InputFbx;
+    FString TargetFbx;
+    FString OutputPath;
+    double StageSeconds[int32(ERetargetStage::Num)] = {};
+    double TotalSeconds = 0.0;
+    int32 NumFrames = 0;
+    int32 NumBones = 0;
+    // FBX files read by imports that missed the cache, and the output file written
+    int64 BytesRead = 0;
+    int64 BytesWritten = 0;
+    // Kept/total keys when the direct FBX writer reduces keys, otherwise 0
+    double KeyRatio = 0.0;
+    // Peak resident memory of the process when the pair finished
+    int64 PeakRssBytes = 0;
+
+    double& operator[](ERetargetStage Stage) { return StageSeconds[int32(Stage)]; }
+    FString ToJson() const;
+};
+
+// Adds the time spent in its scope to one stage
+class FRetargetStageScope {
+public:
+    FRetargetStageScope(FRetargetPairMetrics& InMetrics, ERetargetStage InStage)
+        : Metrics(InMetrics)
+        , Stage(InStage)
+        , StartTime(FPlatformTime::Seconds())
+    {
+    }
+    ~FRetargetStageScope() { Metrics[Stage] += FPlatformTime::Seconds() - StartTime; }
+
+private:
+    FRetargetPairMetrics& Metrics;
+    ERetargetStage Stage;
+    double StartTime;
+};
+
+// Appends pair metrics to a JSONL file, flushed after every pair
+class FRetargetMetricsWriter {
+public:
+    ~FRetargetMetricsWriter();
+    bool Open(const FString& FilePath);
+    void Write(const FRetargetPairMetrics& Metrics);
+
+private:
+    TUniquePtr<FArchive> Archive;
+};
+
+namespace RetargetMetrics {
+const TCHAR* GetStageName(ERetargetStage Stage);
+
+// Saved/Metrics/<Run>_<Session>.jsonl
+FString GetMetricsFile(const FString& Run, const FString& Session);
+
+// Aggregates every metrics file of the run into totals, the largest per-process peak RSS and per-stage
+// percentiles, writes them to Saved/Metrics/<Run>.summary.json and returns the summary JSON
+// (empty when the run has no metrics)
+FString SummarizeRun(const FString& Run, double WallSeconds);
+} // namespace RetargetMetrics
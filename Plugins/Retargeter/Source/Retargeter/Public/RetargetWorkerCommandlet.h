@@ -6,8 +6,17 @@
 #include "Commandlets/Commandlet.h"
 #include "RetargetWorkerCommandlet.generated.h"
 
+struct FRetargetPair;
+
 /**
- * 
+ * Worker process for RetargetAll0. Runs a shared pair queue (-queue=), a legacy split (-subdir=),
+ * or stays resident with -serve [-socket=<path>] and accepts JSON lines over a Unix domain socket:
+ *   {"cmd":"retarget","input":"a.fbx","target":"t.fbx","output":"o.fbx"}
+ *   {"cmd":"retarget","input":"a.fbx","targets":[...],"outputs":[...]}
+ *   {"cmd":"queue","path":"<queue dir>","workerindex":0,"numworkers":4}
+ * Any request may carry "options":"<worker command line options>" to replace the daemon's own.
+ *   {"cmd":"ping"} / {"cmd":"quit"}
+ * Every request gets one reply line such as {"cmd":"retarget","ok":true,"written":1}.
  */
 UCLASS()
 class RETARGETER_API URetargetWorkerCommandlet : public UCommandlet
@@ -19,9 +28,21 @@ public:
 	virtual int32 Main(const FString& Params) override;
 
 private:
+    int32 Serve(const FString& SocketPath);
+    // Absent options fall back to their defaults, so a resident worker takes each run's options as a whole
+    bool ApplyOptions(const FString& Params);
+    FString HandleRequest(const FString& Line, bool& bOutQuit);
+    // Both return the number of outputs written; ProcessQueue returns INDEX_NONE if the queue cannot be opened
+    int32 ProcessQueue(const FString& QueueDir, int32 WorkerIndex, int32 NumWorkers);
+    int32 ProcessJob(const TArray<FRetargetPair>& Pairs);
     void ProcessDirectory(const FString& BasePath, const FString& SubDir, int32 WorkerIndex, int32 NumWorkers, int32 Seed);
     void ProcessTrainDirectory(const FString& TrainPath, int32 WorkerIndex, int32 NumWorkers, int32 Seed);
     void ProcessTestValDirectory(const FString& DirPath, const FString& DirName, int32 WorkerIndex, int32 NumWorkers, int32 Seed);
-    TArray<FString> GetFBXFiles(const FString& DirectoryPath);
-    TArray<FString> GetRandomSubset(const TArray<FString>& InputArray, int32 Count, int32 Seed);
+
+    // Test/val: iterate animations in the outer loop so each source FBX is imported once
+    bool bAnimationMajor = false;
+    // Number of targets retargeted together from one source evaluation
+    int32 FanOut = 8;
+    // Options last passed to ApplyOptions
+    FString AppliedOptions;
 };
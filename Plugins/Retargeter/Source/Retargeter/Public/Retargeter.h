@@ -5,6 +5,9 @@
 #include "Containers/Map.h"
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "RetargetAssetCache.h"
+#include "RetargetGCPolicy.h"
+#include "RetargetMetrics.h"
 #include "Retargeter/IKRetargeter.h"
 
 class UObject;
@@ -13,10 +16,16 @@ class USkeletalMesh;
 class UIKRigDefinition;
 class IAnimationDataController;
 struct FRawAnimSequenceTrack;
-struct FAnimPoseEvaluationOptions;
+class FRetargetSourcePose;
 struct FIKRetargetProcessor;
 struct FRetargetProfile;
 struct FRetargetSkeleton;
+struct FRetargetFbxClip;
+struct FRetargetChunkedClip;
+class FRetargetShardSink;
+class FRetargetMetricsWriter;
+struct FRetargetSimdScratch;
+struct FReferenceSkeleton;
 
 /**
  * Main retargeter module class
@@ -32,17 +41,101 @@ public:
     void SetPersistAssets(bool bInPersist);
     bool GetPersistAssets() const;
 
-    void RetargetAPair(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath);
+    // Read FBX files directly into a reference skeleton and raw bone transforms instead of importing
+    // them through Interchange. Meshes are then transient and skeleton-only.
+    void SetDirectFbxImport(bool bInDirect);
+
+    // Write output FBX files straight from the retargeted tracks, without building a UAnimSequence
+    void SetDirectFbxExport(bool bInDirect);
+
+    // Append outputs to binary shards next to the output path (<dir>/shards) instead of writing FBX files.
+    // Encoding is float32, float16 or snorm16; an empty encoding goes back to FBX output.
+    // Shards are finalized by CloseShards.
+    bool SetShardOutput(const FString& Encoding, int32 MaxShardMB);
+    bool UsesShardOutput() const;
+    void CloseShards();
+
+    // Debug: count heap allocations made inside the frame loop. Installs a counting malloc proxy.
+    void SetCountAllocations(bool bInCount);
+    // Frame allocation counts gathered since the last call; false when counting is off
+    bool ConsumeFrameAllocations(uint64& OutTotal, uint64& OutMax, int32& OutNumFrames);
+
+    // Debug: also run the scalar local-space conversion each frame and compare it with the SIMD keys
+    void SetValidateSimd(bool bInValidate);
+    // Convert every frame to local space with the scalar path instead of the SIMD kernels
+    void SetScalarLocal(bool bInScalar);
+    // Largest relative key error since the last call; false when validation is off
+    bool ConsumeSimdError(float& OutMaxError);
+
+    // Direct FBX export keeps only the keys needed to stay within fixed per-channel tolerances
+    // and drops constant curves to a single key. Has no effect on other outputs.
+    void SetReduceKeys(bool bInReduce);
+
+    // Skip animation compression for transient output sequences. Persisted outputs are still compressed.
+    // Imported source sequences are compressed by the import; only direct FBX import avoids that.
+    void SetSkipCompression(bool bInSkip);
+
+    // Splits clips longer than ChunkFrames into chunks retargeted in parallel, each on its own processor.
+    // Every chunk first replays up to WarmupFrames preceding frames so ops with playback state settle. 0 disables.
+    void SetFrameChunking(int32 ChunkFrames, int32 WarmupFrames);
+    // Debug: also retarget chunked clips sequentially and compare the keys, which measures the warm-up seam error
+    void SetValidateChunks(bool bInValidate);
+    // Largest relative key error of chunked clips since the last call; false when validation is off
+    bool ConsumeChunkError(float& OutMaxError);
+
+    // Appends stage timings, counts and sizes of every pair to Saved/Metrics/<Run>_<session>.jsonl.
+    // An empty run stops writing metrics.
+    bool SetMetricsOutput(const FString& Run);
+
+    // Commandlets collect garbage after a pair only once one of these thresholds is reached (0 disables one)
+    void SetGCPolicy(int32 RssMB, int32 Objects, int32 EveryPairs);
+    FRetargetGCStats ConsumeGCStats();
+
+    // Returns false when no output was written
+    bool RetargetAPair(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath);
+
+    // Keeps up to Depth pairs in flight when retargeting a list: imports and asset creation stay on the
+    // game thread while earlier pairs retarget and write their output on task threads. 1 disables.
+    void SetPipelineDepth(int32 Depth);
+    int32 GetPipelineDepth() const { return PipelineDepth; }
+    // Returns the number of outputs written
+    int32 RetargetPairs(
+        const TArray<FString>& InputFbxs, const TArray<FString>& TargetFbxs, const TArray<FString>& OutputPaths);
+
+    // Retargets one input animation to several targets. The source is imported and evaluated
+    // once per frame, then fed to one retarget processor per target. Returns the number of outputs written.
+    int32 RetargetOneToMany(
+        const FString& InputFbx, const TArray<FString>& TargetFbxs, const TArray<FString>& OutputPaths);
+
+    // Imported FBX assets (and their IK rigs) are kept in LRU caches between pairs.
+    // A zero budget keeps only the most recent file on that side.
+    void SetSourceCacheBudgetMB(int32 BudgetMB);
+    void SetTargetCacheBudgetMB(int32 BudgetMB);
+    void ReleaseSourceCache();
+    void ReleaseTargetCache();
+
+    // Identifies the plugin version and settings that affect retargeted output; part of the manifest key
+    FString GetSettingsFingerprint() const;
 
 private:
     void RegisterMenus();
     void PluginButtonClicked();
 
-    void ClearAssetsInPath(const FString& Path);
+    // /Game/Animations/tmp/<session>; every package this process creates lives below it
+    const FString& GetSessionPackageRoot();
+    // Releases the given objects to the next garbage collection, deletes their saved package files
+    // and adds the time to the cleanup stage
+    int32 DeleteCreatedObjects(TArray<TWeakObjectPtr<UObject>>& Objects);
     void CleanPreviousOutputs();
     TArray<UObject*> ImportFBX(const FString& FbxPath, const FString& DestinationPath);
     void ProcessImportedAssets(const TArray<UObject*>& ImportedAssets, bool bIsInput);
     void LoadFBX(const FString& InputFbx, const FString& TargetFbx);
+    bool LoadCachedFBX(FRetargetAssetCache& Cache, const FString& FbxPath, bool bIsInput);
+    bool ReadFBXDirect(const FString& FbxPath, bool bIsInput, FRetargetCachedAssets& OutEntry);
+    bool HasSourceAnimation() const;
+    int32 GetSourceNumFrames() const;
+    FFrameRate GetSourceFrameRate() const;
+    void ReleaseCachedAssets(TArray<FRetargetCachedAssets>& Evicted);
 
     // This requires the input skeleton:
     // - Has very standard names (no prefix/suffix)
@@ -58,23 +151,70 @@ private:
     bool InitializeRetargetProcessor(FIKRetargetProcessor& Processor, FRetargetProfile& RetargetProfile);
     UAnimSequence* CreateTargetSequence(const FString& OutputName);
     void SetupAnimationController(UAnimSequence* TargetSequence, IAnimationDataController& Ctrl, int32& NumFrames);
-    void ProcessFrameRetargeting(FIKRetargetProcessor& Processor, const FRetargetSkeleton& SourceRig,
-        const FRetargetSkeleton& TargetRig, const TArray<FName>& SourceBoneNames, const TArray<FName>& TargetBoneNames,
-        TArray<FTransform>& SourceComponentPose, TArray<FRawAnimSequenceTrack>& BoneTracks,
-        const FAnimPoseEvaluationOptions& EvalOptions, int32 NumFrames, int32 NumTargetBones);
+    // Pure math over the pair's own buffers, safe to run off the game thread
+    void ProcessFrameRetargeting(FIKRetargetProcessor& Processor, const FRetargetProfile& SettingsProfile,
+        const FRetargetSkeleton& TargetRig, TArray<FTransform>& SourceComponentPose,
+        TArray<FRawAnimSequenceTrack>& BoneTracks, FRetargetSourcePose& SourcePose, int32 NumFrames,
+        int32 NumTargetBones);
+    bool UsesFrameChunks(int32 NumFrames) const { return FrameChunkFrames > 0 && NumFrames > FrameChunkFrames; }
+    // Source clip that can be evaluated off the game thread; imported animations are baked into one
+    TSharedPtr<const FRetargetFbxClip> GetTaskSafeSourceClip();
+    // Sets up a processor per chunk for the current pair; game thread only
+    bool InitializeFrameChunks(TSharedPtr<const FRetargetFbxClip> Clip, FRetargetChunkedClip& OutChunked);
+    // Touches no UObjects
+    void ProcessFrameChunks(FRetargetChunkedClip& Chunked, TArray<FRawAnimSequenceTrack>& BoneTracks);
+    void EvaluateSourceFrame(
+        int32 FrameIndex, FRetargetSourcePose& SourcePose, TArray<FTransform>& OutSourceComponentPose);
+    // Returns the SIMD key error for the frame when validating, otherwise zero
+    float RetargetFrame(FIKRetargetProcessor& Processor, const FRetargetSkeleton& TargetRig,
+        const FRetargetProfile& SettingsProfile, TArray<FTransform>& SourceComponentPose, float DeltaTime,
+        int32 FrameIndex, TArray<FTransform>& TargetLocalPose, FRetargetSimdScratch& SimdScratch,
+        TArray<FRawAnimSequenceTrack>& BoneTracks);
+    void RecordFrameAllocations(uint64 AllocsBefore);
     void CommitBoneTracks(IAnimationDataController& Ctrl, const TArray<FRawAnimSequenceTrack>& BoneTracks,
         const TArray<FName>& TargetBoneNames, int32 NumTargetBones);
     void FinalizeTargetSequence(UAnimSequence* TargetSequence);
-    void CreateOutputCopy(UAnimSequence* TargetSequence);
-    void RetargetWithRTG();
-
-    void ExportOutputAnimationFBX(const FString& OutputPath);
+    bool BuildOutputSequence(const TArray<FRawAnimSequenceTrack>& BoneTracks, const TArray<FName>& TargetBoneNames);
+    bool WriteOutput(const FString& OutputPath, const TArray<FRawAnimSequenceTrack>& BoneTracks,
+        const TArray<FName>& TargetBoneNames);
+    // Shard or direct FBX output; touches no UObjects
+    bool WriteTracksToFile(const FString& OutputPath, const FString& InputName, const FString& TargetName,
+        const FReferenceSkeleton& RefSkeleton, const TArray<FRawAnimSequenceTrack>& BoneTracks,
+        const FFrameRate& FrameRate, FRetargetPairMetrics& Metrics);
+    bool RetargetWithRTG(const FString& OutputPath);
+    void ReleasePairReferences(bool bCollectGarbage = true);
+    // Game-thread stages record into PairMetrics
+    void BeginPairMetrics(const FString& InputFbx, const FString& TargetFbx, const FString& OutputPath);
+    void WritePairMetrics(FRetargetPairMetrics& Metrics, double StartTime);
+
+    bool ExportOutputAnimationFBX(const FString& OutputPath);
 
     static FRetargeterModule* SingletonInstance;
 
     bool bPersistAssets = false;
+    bool bDirectFbxImport = false;
+    bool bDirectFbxExport = false;
+    bool bSkipCompression = false;
+    bool bReduceKeys = false;
+    TSharedPtr<FRetargetShardSink> ShardSink;
+
+    bool bCountAllocs = false;
+    uint64 FrameAllocsTotal = 0;
+    uint64 FrameAllocsMax = 0;
+    int32 NumFramesCounted = 0;
+
+    int32 PipelineDepth = 1;
+    int32 FrameChunkFrames = 0;
+    int32 FrameChunkWarmup = 0;
+
+    bool bValidateSimd = false;
+    bool bScalarLocal = false;
+    float SimdMaxError = 0.f;
+    bool bValidateChunks = false;
+    float ChunkMaxError = 0.f;
 
     UAnimSequence* InputAnimation;
+    TSharedPtr<const FRetargetFbxClip> InputClip;
     USkeletalMesh* InputSkeleton;
     USkeletalMesh* TargetSkeleton;
 
@@ -83,4 +223,16 @@ private:
 
     UIKRetargeter* IKRetargeter = nullptr;
     UAnimSequence* outputAnimation = nullptr;
+
+    FRetargetAssetCache SourceCache;
+    FRetargetAssetCache TargetCache;
+    FString CurrentInputFbx;
+    FString CurrentTargetFbx;
+    int32 NextCachePackageId = 0;
+    FString SessionPackageRoot;
+    // Retargeters and output sequences created for the current pair, released by CleanPreviousOutputs
+    TArray<TWeakObjectPtr<UObject>> PairCreatedObjects;
+    FRetargetPairMetrics PairMetrics;
+    TSharedPtr<FRetargetMetricsWriter> MetricsWriter;
+    FRetargetGCPolicy GCPolicy;
 };
@@ -40,9 +40,13 @@ public class Retargeter : ModuleRules
 					"IKRig", "IKRigEditor", "EditorScriptingUtilities",
 					"EditorFramework",
 					"Engine",
-					"ToolMenus", "Slate", "SlateCore"
+					"ToolMenus", "Slate", "SlateCore",
+					"Json", "Projects"
 				}
 				);
+
+			// FBX SDK for the direct FBX reader
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "FBX");
 		}
 
 